@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare casting floats and doubles to strings and decimals with formatting them by iostream, and casting strings to
+// numbers with `std::stoll` and `std::stod`, as it was done.
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "calc/casting.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::bench;
+using dingodb::types::DecimalP;
+
+static const size_t ROWS = 100000;
+
+static std::string FormatFixed(double v, int precision) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(precision) << v;
+  return ss.str();
+}
+
+template <typename T, typename F>
+static double MeasureCast(const std::vector<T> &values, F cast) {
+  return Measure(values.size(), [&]() {
+    size_t count = 0;
+    for (const auto &v : values) {
+      count += cast(v);
+    }
+    return count;
+  });
+}
+
+int main() {
+  std::vector<float> floats;
+  std::vector<double> doubles;
+  for (size_t i = 0; i < ROWS; ++i) {
+    floats.push_back(static_cast<float>(i) / 7.0f);
+    doubles.push_back(static_cast<double>(i) / 7.0);
+  }
+  std::vector<String> int_strings;
+  std::vector<String> double_strings;
+  for (size_t i = 0; i < ROWS; ++i) {
+    int_strings.emplace_back(std::to_string(i * 7919));
+    double_strings.emplace_back(FormatFixed(doubles[i], 4));
+  }
+  printf("%-16s %10s %10s  (ns/row)\n", "cast", "iostream", "direct");
+  printf("%-16s %10.1f %10.1f\n", "float->string",
+         MeasureCast(floats, [](float v) { return FormatFixed(v, 15).size(); }),
+         MeasureCast(floats, [](float v) { return (*calc::Cast<String>(v)).size(); }));
+  printf("%-16s %10.1f %10.1f\n", "float->decimal",
+         MeasureCast(floats, [](float v) { return DecimalP(FormatFixed(v, 6)).GetScale(); }),
+         MeasureCast(floats, [](float v) { return calc::Cast<DecimalP>(v).GetScale(); }));
+  printf("%-16s %10.1f %10.1f\n", "double->decimal",
+         MeasureCast(doubles, [](double v) { return DecimalP(FormatFixed(v, 14)).GetScale(); }),
+         MeasureCast(doubles, [](double v) { return calc::Cast<DecimalP>(v).GetScale(); }));
+  printf("%-16s %10.1f %10.1f\n", "string->int64",
+         MeasureCast(int_strings, [](const String &v) { return std::stoll(std::string(*v)); }),
+         MeasureCast(int_strings, [](const String &v) { return calc::Cast<int64_t>(v); }));
+  printf("%-16s %10.1f %10.1f\n", "string->double",
+         MeasureCast(double_strings, [](const String &v) { return std::stod(std::string(*v)) > 0; }),
+         MeasureCast(double_strings, [](const String &v) { return calc::Cast<double>(v) > 0; }));
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare the aggregation `SUM` over int64 values, fixed-point decimal values and decimal values in GMP, and the
+// comparison of decimals with comparing them by formatting.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "rel/rel_runner.h"
+#include "runner.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::rel;
+using namespace dingodb::bench;
+using dingodb::types::Decimal;
+using dingodb::types::DecimalP;
+
+static const size_t ROWS = 100000;
+
+template <typename F>
+static double MeasureAgg(const std::string &code, F make) {
+  std::vector<Operand> values;
+  values.reserve(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    values.emplace_back(make(i));
+  }
+  auto rel = MakeRunner<RelRunner>(code);
+  return Measure(ROWS, [&]() {
+    for (size_t i = 0; i < ROWS; ++i) {
+      rel->Put(new Tuple{values[i]});
+    }
+    std::unique_ptr<const Tuple> out(rel->Get());
+    return out != nullptr ? out->size() : 0;
+  });
+}
+
+static std::string DecimalString(size_t i) {
+  return std::to_string(i) + "." + std::to_string(i % 100);
+}
+
+// Comparing as `Decimal` did, by formatting and parsing both.
+static bool LessByString(const Decimal &v0, const Decimal &v1) {
+  return cmp(mpf_class(v0.toString()), mpf_class(v1.toString())) < 0;
+}
+
+template <typename T, typename F>
+static double MeasureLess(const std::vector<T> &values, F less) {
+  return Measure(values.size() - 1, [&]() {
+    size_t count = 0;
+    for (size_t i = 1; i < values.size(); ++i) {
+      count += less(values[i - 1], values[i]);
+    }
+    return count;
+  });
+}
+
+static double MeasureDecode(const std::string &code) {
+  auto len = code.size() / 2;
+  std::vector<Byte> buf(len);
+  HexToBytes(buf.data(), code.data(), code.size());
+  return Measure(ROWS, [&]() {
+    size_t count = 0;
+    for (size_t i = 0; i < ROWS; ++i) {
+      Runner runner;
+      runner.Decode(buf.data(), len);
+      count += 1;
+    }
+    return count;
+  });
+}
+
+int main() {
+  // AGG(input, SUM($[0]))
+  printf("%-16s %10.1f ns/row\n", "int64",
+         MeasureAgg("74012200", [](size_t i) { return Operand(static_cast<int64_t>(i)); }));
+  printf("%-16s %10.1f ns/row\n", "decimal (fixed)",
+         MeasureAgg("74012600", [](size_t i) { return Operand(DecimalP(DecimalString(i))); }));
+  printf("%-16s %10.1f ns/row\n", "decimal (gmp)",
+         MeasureAgg("74012600", [](size_t i) { return Operand(DecimalP(Decimal(DecimalString(i)))); }));
+  // AGG(input, GROUP(0), COUNT())
+  printf("%-16s %10.1f ns/row\n", "group (fixed)",
+         MeasureAgg("736101000110", [](size_t i) { return Operand(DecimalP(DecimalString(i % 1000))); }));
+  std::vector<Decimal> decimals;
+  std::vector<DecimalP> fixed;
+  for (size_t i = 0; i < ROWS; ++i) {
+    auto str = DecimalString((i * 7919) % ROWS);
+    decimals.emplace_back(str);
+    fixed.emplace_back(str);
+  }
+  printf("%-16s %10.1f ns/cmp\n", "< (string)", MeasureLess(decimals, LessByString));
+  printf("%-16s %10.1f ns/cmp\n", "< (gmp)",
+         MeasureLess(decimals, [](const Decimal &v0, const Decimal &v1) { return v0 < v1; }));
+  printf("%-16s %10.1f ns/cmp\n", "< (fixed)",
+         MeasureLess(fixed, [](const DecimalP &v0, const DecimalP &v1) { return v0 < v1; }));
+  // 12345678.9012 + 1, in text and binary form.
+  printf("%-16s %10.1f ns/decode\n", "const (text)", MeasureDecode("160D31323334353637382E393031321601318306"));
+  printf("%-16s %10.1f ns/decode\n", "const (binary)", MeasureDecode("2604051CBE991A14260001018306"));
+  return 0;
+}
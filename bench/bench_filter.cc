@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare putting tuples one by one with putting batches, for a filter followed by a projection or an aggregation, in
+// which about 1% of the rows pass the filter.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "rel/rel_runner.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::rel;
+using namespace dingodb::bench;
+
+static const size_t ROWS = 4096;
+static const size_t ROUNDS = 200;
+
+struct Case {
+  const char *name;
+  const char *code;
+};
+
+static const Case CASES[] = {
+    // PROJECT(FILTER(input, $[0] < 41), $[0], $[1] * 2L, $[2] + 1.0)
+    {"filter+project", "71310011299501007231003201120285023502153FF0000000000000830500"},
+    // AGG(FILTER(input, $[0] < 41), COUNT(), SUM($[1]), MAX($[2]))
+    {"filter+agg", "713100112995010074031022013502"},
+};
+
+static Tuple MakeRow(size_t i) {
+  return Tuple{static_cast<int32_t>(i % 4096), static_cast<int64_t>(i), static_cast<double>(i) / 2};
+}
+
+static double MeasureTuples(const std::string &code) {
+  auto rel = MakeRunner<RelRunner>(code);
+  return Measure(ROUNDS * ROWS, [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      for (size_t i = 0; i < ROWS; ++i) {
+        std::unique_ptr<const Tuple> out(rel->Put(new Tuple(MakeRow(i))));
+        count += (out != nullptr);
+      }
+    }
+    std::unique_ptr<const Tuple> out(rel->Get());
+    return count;
+  });
+}
+
+static double MeasureBatches(const std::string &code) {
+  auto rel = MakeRunner<RelRunner>(code);
+  return Measure(ROUNDS * ROWS, [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      // Building the batch is counted, as building the tuples is.
+      auto *batch = new Batch(ROWS);
+      auto c0 = Column::Make<int32_t>(TYPE_INT32, ROWS);
+      auto c1 = Column::Make<int64_t>(TYPE_INT64, ROWS);
+      auto c2 = Column::Make<double>(TYPE_DOUBLE, ROWS);
+      for (size_t i = 0; i < ROWS; ++i) {
+        c0.Set<int32_t>(i, static_cast<int32_t>(i % 4096));
+        c1.Set<int64_t>(i, static_cast<int64_t>(i));
+        c2.Set<double>(i, static_cast<double>(i) / 2);
+      }
+      batch->AddColumn(c0);
+      batch->AddColumn(c1);
+      batch->AddColumn(c2);
+      std::shared_ptr<uint64_t[]> selection;
+      std::unique_ptr<const Batch> out(rel->PutBatch(batch, selection));
+      count += (out != nullptr);
+    }
+    std::unique_ptr<const Tuple> out(rel->Get());
+    return count;
+  });
+}
+
+int main() {
+  printf("%-16s %14s %14s\n", "case", "tuples", "batches");
+  for (const auto &c : CASES) {
+    printf("%-16s %11.1f ns %11.1f ns\n", c.name, MeasureTuples(c.code), MeasureBatches(c.code));
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare `t0 > c`, which is fused into one operator, with `c < t0`, which is not, for each type.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "runner.h"
+#include "vm_runner.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::bench;
+
+static const size_t ROWS = 1024;
+static const size_t ROUNDS = 500;
+
+struct Case {
+  const char *name;
+  const char *fused;
+  const char *not_fused;
+  Operand (*make)(size_t i);
+};
+
+static const Case CASES[] = {
+    {"INT32", "310011059301", "110531009501", [](size_t i) { return Operand(static_cast<int32_t>(i % 10)); }},
+    {"INT64", "320012059302", "120532009502", [](size_t i) { return Operand(static_cast<int64_t>(i % 10)); }},
+    {"FLOAT", "34001440A000009304", "1440A0000034009504", [](size_t i) { return Operand(static_cast<float>(i % 10)); }},
+    {"DOUBLE", "35001540140000000000009305", "15401400000000000035009505",
+     [](size_t i) { return Operand(static_cast<double>(i % 10)); }},
+    {"DECIMAL", "36001601359306", "16013536009506", [](size_t i) { return Operand(DecimalP(std::to_string(i % 10))); }},
+    {"STRING", "37001701359307", "17013537009507",
+     [](size_t i) { return Operand(std::make_shared<std::string>(std::to_string(i % 10))); }},
+    {"DATE", "380018059308", "180538009508", [](size_t i) { return Operand(static_cast<int64_t>(i % 10)); }},
+    {"TIMESTAMP", "390019059309", "190539009509", [](size_t i) { return Operand(static_cast<int64_t>(i % 10)); }},
+};
+
+template <typename R>
+static double MeasureRun(const std::string &input, const std::vector<Tuple> &rows) {
+  auto runner = MakeRunner<R>(input);
+  return Measure(ROUNDS * rows.size(), [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      for (const auto &row : rows) {
+        runner->BindTuple(&row);
+        runner->Run();
+        count += (runner->Get() == Operand(true));
+      }
+    }
+    return count;
+  });
+}
+
+int main() {
+  printf("%-10s %14s %14s %14s %14s\n", "type", "stack fused", "stack", "vm fused", "vm");
+  for (const auto &c : CASES) {
+    std::vector<Tuple> rows;
+    rows.reserve(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+      rows.push_back(Tuple{c.make(i)});
+    }
+    printf("%-10s %11.1f ns %11.1f ns %11.1f ns %11.1f ns\n", c.name, MeasureRun<Runner>(c.fused, rows),
+           MeasureRun<Runner>(c.not_fused, rows), MeasureRun<VmRunner>(c.fused, rows),
+           MeasureRun<VmRunner>(c.not_fused, rows));
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare the kernels of each instruction set supported, for comparisons and arithmetic over columns of each type, and
+// for casts, with casting row by row by `calc::Cast`.
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "bench_util.h"
+#include "calc/kernels.h"
+
+using namespace dingodb::expr::calc;
+using namespace dingodb::bench;
+
+static const size_t ROWS = 4096;
+static const size_t ROUNDS = 20000;
+
+static const char *const LEVELS[] = {"scalar", "sse4.2", "avx2"};
+
+template <typename R, typename T>
+static double MeasureKernel(KernelOp op, KernelLevel level) {
+  std::vector<T> v0(ROWS);
+  std::vector<T> v1(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    v0[i] = static_cast<T>(i % 10);
+    v1[i] = static_cast<T>(i % 7);
+  }
+  auto out = std::make_unique<R[]>(ROWS);
+  auto kernel = GetKernel<R, T>(op, level);
+  return Measure(ROUNDS * ROWS, [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      count += kernel(v0.data(), v1.data(), out.get(), ROWS);
+      count += static_cast<size_t>(out[k % ROWS]);
+    }
+    return count;
+  });
+}
+
+template <typename T>
+static void Run(const char *name) {
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    printf("%-8s %-8s %10.3f %10.3f %10.3f\n", name, LEVELS[level],
+           MeasureKernel<bool, T>(KERNEL_LT, KernelLevel(level)), MeasureKernel<T, T>(KERNEL_ADD, KernelLevel(level)),
+           MeasureKernel<T, T>(KERNEL_MUL, KernelLevel(level)));
+  }
+}
+
+template <typename D, typename S, D (*Calc)(S)>
+static double MeasureCast(int level) {
+  std::vector<S> in(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    in[i] = static_cast<S>(i) / 3;
+  }
+  auto out = std::make_unique<D[]>(ROWS);
+  auto kernel = GetCastKernel<D, S>(CastKernelOpOf<D, S, Calc>(), KernelLevel(level));
+  return Measure(ROUNDS * ROWS, [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      // Level -1 for casting row by row.
+      if (level < 0) {
+        for (size_t i = 0; i < ROWS; ++i) {
+          out[i] = Calc(in[i]);
+        }
+      } else {
+        count += kernel(in.data(), out.get(), ROWS);
+      }
+      count += static_cast<size_t>(out[k % ROWS]);
+    }
+    return count;
+  });
+}
+
+static void RunCast() {
+  printf("\n%-8s %10s %10s %10s %10s  (ns/row)\n", "level", "i64->i32c", "f64->i32c", "i32->f64", "f64->f32");
+  for (int level = -1; level <= GetKernelLevel(); ++level) {
+    printf("%-8s %10.3f %10.3f %10.3f %10.3f\n", level < 0 ? "per-row" : LEVELS[level],
+           MeasureCast<int32_t, int64_t, CastCheck<int32_t, int64_t>>(level),
+           MeasureCast<int32_t, double, CastCheck<int32_t, double>>(level),
+           MeasureCast<double, int32_t, Cast<double, int32_t>>(level),
+           MeasureCast<float, double, Cast<float, double>>(level));
+  }
+}
+
+int main() {
+  printf("%-8s %-8s %10s %10s %10s  (ns/row)\n", "type", "level", "lt", "add", "mul");
+  Run<int32_t>("INT32");
+  Run<int64_t>("INT64");
+  Run<float>("FLOAT");
+  Run<double>("DOUBLE");
+  RunCast();
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measure the memory of tuples and the cost of moving operands around, by copying tuples and running expressions.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "runner.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::bench;
+
+static const size_t ROWS = 100000;
+static const size_t ROUNDS = 20;
+
+// Rows of (int32, int64, double, short string), the strings are inline.
+static std::vector<Tuple> MakeRows() {
+  std::vector<Tuple> rows;
+  rows.reserve(ROWS);
+  for (size_t i = 0; i < ROWS; ++i) {
+    rows.push_back(Tuple{static_cast<int32_t>(i % 10), static_cast<int64_t>(i * 3), static_cast<double>(i) / 4,
+                         "s" + std::to_string(i % 100)});
+  }
+  return rows;
+}
+
+static double MeasureRun(const std::string &input, const std::vector<Tuple> &rows) {
+  auto runner = MakeRunner<Runner>(input);
+  return Measure(ROUNDS * ROWS, [&]() {
+    size_t count = 0;
+    for (size_t k = 0; k < ROUNDS; ++k) {
+      for (const auto &row : rows) {
+        runner->BindTuple(&row);
+        runner->Run();
+        count += (runner->Get() != nullptr);
+      }
+    }
+    return count;
+  });
+}
+
+int main() {
+  auto rows = MakeRows();
+  printf("sizeof(Operand): %zu bytes, %zu bytes per row of 4 columns\n", sizeof(Operand), 4 * sizeof(Operand));
+  printf("copy tuples:       %8.1f ns/row\n", Measure(ROUNDS * ROWS, [&]() {
+           size_t count = 0;
+           for (size_t k = 0; k < ROUNDS; ++k) {
+             auto copy = rows;
+             count += copy.size();
+           }
+           return count;
+         }));
+  // t0 > 5 && t3 = 's42'
+  printf("filter:            %8.1f ns/row\n", MeasureRun("31001105930137031703733432910752", rows));
+  // t3, t2, t1, t0
+  printf("project:           %8.1f ns/row\n", MeasureRun("3703350232013100", rows));
+  // t1 * 2L + int64(t0)
+  printf("arithmetic:        %8.1f ns/row\n", MeasureRun("3201120285023100F0218302", rows));
+  return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _BENCH_BENCH_UTIL_H_
+#define _BENCH_BENCH_UTIL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types.h"
+#include "utils.h"
+
+namespace dingodb::bench {
+
+// Keep the results from being optimized out.
+inline volatile size_t sink;
+
+/**
+ * @brief Run `f`, which returns a count kept in `sink`, and get the nanoseconds it takes per item.
+ */
+template <typename F>
+double Measure(size_t items, F f) {
+  auto start = std::chrono::steady_clock::now();
+  size_t count = f();
+  auto end = std::chrono::steady_clock::now();
+  sink = count;
+  return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(items);
+}
+
+/**
+ * @brief Make a runner, e.g. `Runner`, `VmRunner` or `RelRunner`, of the code in hex.
+ */
+template <typename R>
+std::unique_ptr<R> MakeRunner(const std::string &code) {
+  auto len = code.size() / 2;
+  std::vector<expr::Byte> buf(len);
+  expr::HexToBytes(buf.data(), code.data(), code.size());
+  auto runner = std::make_unique<R>();
+  runner->Decode(buf.data(), len);
+  return runner;
+}
+
+}  // namespace dingodb::bench
+
+#endif /* _BENCH_BENCH_UTIL_H_ */
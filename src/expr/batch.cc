@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "batch.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "exception.h"
+
+namespace dingodb::expr {
+
+// Call `fun` with a null pointer of the C++ type corresponding to `type`, as a type tag.
+template <typename F>
+static void ForType(Byte type, F &&fun) {
+  switch (type) {
+  case TYPE_INT32:
+    fun(static_cast<TypeOf<TYPE_INT32> *>(nullptr));
+    break;
+  case TYPE_INT64:
+    fun(static_cast<TypeOf<TYPE_INT64> *>(nullptr));
+    break;
+  case TYPE_BOOL:
+    fun(static_cast<TypeOf<TYPE_BOOL> *>(nullptr));
+    break;
+  case TYPE_FLOAT:
+    fun(static_cast<TypeOf<TYPE_FLOAT> *>(nullptr));
+    break;
+  case TYPE_DOUBLE:
+    fun(static_cast<TypeOf<TYPE_DOUBLE> *>(nullptr));
+    break;
+  case TYPE_DECIMAL:
+    fun(static_cast<TypeOf<TYPE_DECIMAL> *>(nullptr));
+    break;
+  case TYPE_STRING:
+    fun(static_cast<TypeOf<TYPE_STRING> *>(nullptr));
+    break;
+  case TYPE_DATE:
+    fun(static_cast<TypeOf<TYPE_DATE> *>(nullptr));
+    break;
+  case TYPE_TIMESTAMP:
+    fun(static_cast<TypeOf<TYPE_TIMESTAMP> *>(nullptr));
+    break;
+  default:
+    throw ExprError(std::string("Unsupported column type: ") + TypeName(type));
+  }
+}
+
+Column Column::Make(Byte type, size_t size) {
+  Column column;
+  ForType(type, [&](auto *tag) { column = Make<std::remove_pointer_t<decltype(tag)>>(type, size); });
+  return column;
+}
+
+void Column::SetAllValid() {
+  auto words = ValidityWords(m_size);
+  std::fill_n(m_validity.get(), words, ~0ULL);
+}
+
+void Column::CopyValidity(const Column &v) {
+  std::copy_n(v.m_validity.get(), ValidityWords(m_size), m_validity.get());
+}
+
+void Column::AndValidity(const Column &v0, const Column &v1) {
+  auto words = ValidityWords(m_size);
+  for (size_t i = 0; i < words; ++i) {
+    m_validity[i] = v0.m_validity[i] & v1.m_validity[i];
+  }
+}
+
+Column Column::Masked(const uint64_t *mask) const {
+  Column column(*this);
+  auto words = ValidityWords(m_size);
+  column.m_validity = std::shared_ptr<uint64_t[]>(new uint64_t[words]);
+  for (size_t i = 0; i < words; ++i) {
+    column.m_validity[i] = m_validity[i] & mask[i];
+  }
+  return column;
+}
+
+Operand Column::GetOperand(size_t i) const {
+  if (IsNull(i)) {
+    return nullptr;
+  }
+  Operand result;
+  ForType(m_type, [&](auto *tag) { result = Values<std::remove_pointer_t<decltype(tag)>>()[i]; });
+  return result;
+}
+
+void Column::SetOperand(size_t i, const Operand &v) {
+  if (v == nullptr) {
+    SetNull(i);
+    return;
+  }
+  ForType(m_type, [&](auto *tag) {
+    using T = std::remove_pointer_t<decltype(tag)>;
+    Set<T>(i, v.GetValue<T>());
+  });
+}
+
+Tuple *Batch::GetTuple(size_t row) const {
+  auto *tuple = new Tuple(m_columns.size());
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    (*tuple)[i] = m_columns[i].GetOperand(row);
+  }
+  return tuple;
+}
+
+}  // namespace dingodb::expr
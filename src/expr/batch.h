@@ -0,0 +1,198 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_BATCH_H_
+#define _EXPR_BATCH_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "operand.h"
+#include "types.h"
+
+namespace dingodb::expr {
+
+/**
+ * @brief A column of values of the same type, with a validity bitmap marking the non-null ones.
+ *
+ * The storage is shared between copies of a column, so a column must not be modified after it is copied.
+ */
+class Column {
+ public:
+  Column() : m_type(TYPE_NULL), m_size(0) {
+  }
+
+  /**
+   * @brief Make a column with all the values set to null.
+   *
+   * @tparam T the C++ type of the values
+   * @param type the type byte
+   * @param size the number of values
+   * @return Column the column made
+   */
+  template <typename T>
+  static Column Make(Byte type, size_t size) {
+    Column column;
+    column.m_type = type;
+    column.m_size = size;
+    column.m_values = std::shared_ptr<void>(new T[size](), std::default_delete<T[]>());
+    column.m_validity = std::shared_ptr<uint64_t[]>(new uint64_t[ValidityWords(size)]());
+    return column;
+  }
+
+  /**
+   * @brief Make a column of the specified type with all the values set to null.
+   *
+   * @param type the type byte
+   * @param size the number of values
+   * @return Column the column made
+   */
+  static Column Make(Byte type, size_t size);
+
+  Byte GetType() const {
+    return m_type;
+  }
+
+  size_t Size() const {
+    return m_size;
+  }
+
+  template <typename T>
+  const T *Values() const {
+    return static_cast<const T *>(m_values.get());
+  }
+
+  template <typename T>
+  T *Values() {
+    return static_cast<T *>(m_values.get());
+  }
+
+  const uint64_t *Validity() const {
+    return m_validity.get();
+  }
+
+  uint64_t *Validity() {
+    return m_validity.get();
+  }
+
+  bool IsNull(size_t i) const {
+    return ((m_validity[i >> 6] >> (i & 63)) & 1) == 0;
+  }
+
+  void SetNull(size_t i) {
+    m_validity[i >> 6] &= ~(1ULL << (i & 63));
+  }
+
+  template <typename T>
+  void Set(size_t i, T v) {
+    Values<T>()[i] = v;
+    m_validity[i >> 6] |= (1ULL << (i & 63));
+  }
+
+  void SetAllValid();
+
+  void CopyValidity(const Column &v);
+
+  void AndValidity(const Column &v0, const Column &v1);
+
+  /**
+   * @brief Get a column sharing the values, with the rows not in the mask set to null.
+   */
+  Column Masked(const uint64_t *mask) const;
+
+  /**
+   * @brief Get a value boxed in an `Operand`, slow but convenient.
+   */
+  Operand GetOperand(size_t i) const;
+
+  /**
+   * @brief Set a value from an `Operand`, which must hold a value of the column type or null.
+   */
+  void SetOperand(size_t i, const Operand &v);
+
+  static size_t ValidityWords(size_t size) {
+    return (size + 63) >> 6;
+  }
+
+ private:
+  Byte m_type;
+  size_t m_size;
+  std::shared_ptr<void> m_values;
+  std::shared_ptr<uint64_t[]> m_validity;
+};
+
+/**
+ * @brief A chunk of rows stored column by column.
+ */
+class Batch {
+ public:
+  Batch(size_t size) : m_size(size) {
+  }
+
+  size_t Size() const {
+    return m_size;
+  }
+
+  void AddColumn(const Column &column) {
+    m_columns.push_back(column);
+  }
+
+  size_t ColumnNum() const {
+    return m_columns.size();
+  }
+
+  const Column &operator[](size_t index) const {
+    return m_columns[index];
+  }
+
+  /**
+   * @brief Get a row as a tuple, which must be released by the caller.
+   */
+  Tuple *GetTuple(size_t row) const;
+
+ private:
+  size_t m_size;
+  std::vector<Column> m_columns;
+};
+
+/**
+ * @brief Call `fun` with the index of each row selected, skipping 64 rows at a time where none is selected.
+ *
+ * @param selection the bitmap of the rows selected, `nullptr` if all rows are selected
+ * @param size the number of rows
+ */
+template <typename F>
+void ForEachSelected(const uint64_t *selection, size_t size, F &&fun) {
+  if (selection == nullptr) {
+    for (size_t i = 0; i < size; ++i) {
+      fun(i);
+    }
+    return;
+  }
+  auto words = Column::ValidityWords(size);
+  for (size_t w = 0; w < words; ++w) {
+    for (auto bits = selection[w]; bits != 0; bits &= bits - 1) {
+      auto i = (w << 6) + __builtin_ctzll(bits);
+      if (i >= size) {
+        return;
+      }
+      fun(i);
+    }
+  }
+}
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_BATCH_H_ */
@@ -17,11 +17,6 @@
 #include "arithmetic.h"
 #include "../exception.h"
 
-typedef __int128 int128;
-#define INT64CONST(x)  (x##L)
-#define EXPR_INT64_MIN	(-INT64CONST(0x7FFFFFFFFFFFFFFF) - 1)
-#define EXPR_INT64_MAX	INT64CONST(0x7FFFFFFFFFFFFFFF)
-
 namespace dingodb::expr::calc {
 template <>
 Operand Div<int>(int v0, int v1) {
@@ -51,35 +46,29 @@ Operand Div<::dingodb::types::DecimalP>(
 
 template <>
 long Add<long>(long v0, long v1) {
-  int128 result = (int128)v0 + (int128)v1;
-
-  if (result > EXPR_INT64_MAX || result < EXPR_INT64_MIN) {
+  long result;
+  if (!AddChecked(v0, v1, result)) {
     throw ExceedsLimits<TYPE_INT64>();
   }
-
-  return (long)result;
+  return result;
 }
 
 template <>
 long Sub<long>(long v0, long v1) {
-  int128 result = (int128)v0 - (int128)v1;
-
-  if (result > EXPR_INT64_MAX || result < EXPR_INT64_MIN) {
+  long result;
+  if (!SubChecked(v0, v1, result)) {
     throw ExceedsLimits<TYPE_INT64>();
   }
-
-  return (long)result;
+  return result;
 }
 
 template <>
 long Mul<long>(long v0, long v1) {
-  int128 result = (int128)v0 * (int128)v1;
-
-  if (result > EXPR_INT64_MAX || result < EXPR_INT64_MIN) {
+  long result;
+  if (!MulChecked(v0, v1, result)) {
     throw ExceedsLimits<TYPE_INT64>();
   }
-
-  return (long)result;
+  return result;
 }
 
-}  // namespace dingodb::expr::calc
\ No newline at end of file
+}  // namespace dingodb::expr::calc
@@ -29,6 +29,26 @@ T Neg(T v) {
   return -v;
 }
 
+/**
+ * @brief Add without throwing, the overflow is detected by the carry of the instruction.
+ *
+ * @return false if the result overflows
+ */
+template <typename T>
+bool AddChecked(T v0, T v1, T &result) {
+  return !__builtin_add_overflow(v0, v1, &result);
+}
+
+template <typename T>
+bool SubChecked(T v0, T v1, T &result) {
+  return !__builtin_sub_overflow(v0, v1, &result);
+}
+
+template <typename T>
+bool MulChecked(T v0, T v1, T &result) {
+  return !__builtin_mul_overflow(v0, v1, &result);
+}
+
 template <typename T>
 T Add(T v0, T v1) {
   return v0 + v1;
@@ -14,11 +14,15 @@
 
 #include "casting.h"
 
+#include <cerrno>
+#include <charconv>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <malloc.h>
 
+#include "../batch.h"
 #include "../exception.h"
 
 namespace dingodb::expr::calc {
@@ -1481,6 +1485,576 @@ void d2s_internal(char * ascii, double num)
   }
 }
 
+/*
+ * Shortest round-trip formatting of float, by the Ryu algorithm for 32-bit floats, the counterpart of
+ * `double_to_shortest_decimal_bufn`.
+ */
+#define FLOAT_MANTISSA_BITS 23
+#define FLOAT_EXPONENT_BITS 8
+#define FLOAT_BIAS 127
+#define FLOAT_POW5_INV_BITCOUNT 59
+#define FLOAT_POW5_BITCOUNT 61
+#define FLOAT_POW5_INV_TABLE_SIZE 31
+#define FLOAT_POW5_TABLE_SIZE 47
+
+/* Tables of 5^-i and 5^i scaled to 59 and 61 significant bits, generated at compiling time. */
+struct FloatPow5Tables
+{
+  uint64 inv[FLOAT_POW5_INV_TABLE_SIZE];
+  uint64 pow[FLOAT_POW5_TABLE_SIZE];
+
+  static constexpr int32 bitLength(uint128 v)
+  {
+    int32 n = 0;
+    for (; v != 0; v >>= 1)
+      ++n;
+    return n;
+  }
+
+  constexpr FloatPow5Tables() : inv(), pow()
+  {
+    uint128 pow5 = 1;
+    for (int32 i = 0; i < FLOAT_POW5_TABLE_SIZE; ++i, pow5 *= 5)
+    {
+      const int32 len = bitLength(pow5);
+      if (i < FLOAT_POW5_INV_TABLE_SIZE)
+      {
+        /* floor(2^j / 5^i) + 1, 2^128 is out of range but not divisible by 5^i. */
+        const int32 j = len - 1 + FLOAT_POW5_INV_BITCOUNT;
+        const uint128 quotient = (j == 128 ? ~(uint128) 0 / pow5 : ((uint128) 1 << j) / pow5);
+        inv[i] = (uint64) (quotient + 1);
+      }
+      pow[i] = (uint64) (len > FLOAT_POW5_BITCOUNT ? pow5 >> (len - FLOAT_POW5_BITCOUNT)
+                                                   : pow5 << (FLOAT_POW5_BITCOUNT - len));
+    }
+  }
+};
+
+static constexpr FloatPow5Tables FLOAT_POW5_TABLES;
+
+typedef struct floating_decimal_32
+{
+  uint32	mantissa;
+  int32		exponent;
+} floating_decimal_32;
+
+static inline uint32 pow5Factor32(uint32 value)
+{
+  uint32 count = 0;
+
+  for (;;)
+  {
+    const uint32 q = value / 5;
+    const uint32 r = value - 5 * q;
+
+    if (r != 0)
+      break;
+    value = q;
+    ++count;
+  }
+  return count;
+}
+
+static inline bool multipleOfPowerOf5_32(const uint32 value, const uint32 p)
+{
+  return pow5Factor32(value) >= p;
+}
+
+static inline bool multipleOfPowerOf2_32(const uint32 value, const uint32 p)
+{
+  return (value & ((1u << p) - 1)) == 0;
+}
+
+static inline uint32 mulShift32(const uint32 m, const uint64 factor, const int32 shift)
+{
+  const uint32 factorLo = (uint32) (factor);
+  const uint32 factorHi = (uint32) (factor >> 32);
+  const uint64 bits0 = (uint64) m * factorLo;
+  const uint64 bits1 = (uint64) m * factorHi;
+  const uint64 sum = (bits0 >> 32) + bits1;
+
+  Assert(shift > 32);
+  return (uint32) (sum >> (shift - 32));
+}
+
+static inline uint32 mulPow5InvDivPow2(const uint32 m, const uint32 q, const int32 j)
+{
+  return mulShift32(m, FLOAT_POW5_TABLES.inv[q], j);
+}
+
+static inline uint32 mulPow5divPow2(const uint32 m, const uint32 i, const int32 j)
+{
+  return mulShift32(m, FLOAT_POW5_TABLES.pow[i], j);
+}
+
+static inline floating_decimal_32 f2d(const uint32 ieeeMantissa, const uint32 ieeeExponent)
+{
+  int32 e2;
+  uint32 m2;
+
+  if (ieeeExponent == 0)
+  {
+    /* We subtract 2 so that the bounds computation has 2 additional bits. */
+    e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+    m2 = ieeeMantissa;
+  }
+  else
+  {
+    e2 = ieeeExponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+    m2 = (1u << FLOAT_MANTISSA_BITS) | ieeeMantissa;
+  }
+
+  const bool even = (m2 & 1) == 0;
+  const bool acceptBounds = even;
+
+  /* Step 2: Determine the interval of legal decimal representations. */
+  const uint32 mv = 4 * m2;
+  const uint32 mp = 4 * m2 + 2;
+  /* Implicit bool -> int conversion. True is 1, false is 0. */
+  const uint32 mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+  const uint32 mm = 4 * m2 - 1 - mmShift;
+
+  /* Step 3: Convert to a decimal power base using 64-bit arithmetic. */
+  uint32 vr, vp, vm;
+  int32 e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  uint8 lastRemovedDigit = 0;
+
+  if (e2 >= 0)
+  {
+    const uint32 q = log10Pow2(e2);
+    e10 = q;
+
+    const int32 k = FLOAT_POW5_INV_BITCOUNT + pow5bits(q) - 1;
+    const int32 i = -e2 + q + k;
+
+    vr = mulPow5InvDivPow2(mv, q, i);
+    vp = mulPow5InvDivPow2(mp, q, i);
+    vm = mulPow5InvDivPow2(mm, q, i);
+
+    if (q != 0 && (vp - 1) / 10 <= vm / 10)
+    {
+      /*
+       * We need to know one removed digit even if we are not going to loop
+       * below. We could use q = X - 1 above, except that would require
+       * 33 bits for the result, and we've found that 32-bit arithmetic is
+       * faster even on 64-bit machines.
+       */
+      const int32 l = FLOAT_POW5_INV_BITCOUNT + pow5bits(q - 1) - 1;
+
+      lastRemovedDigit = (uint8) (mulPow5InvDivPow2(mv, q - 1, -e2 + q - 1 + l) % 10);
+    }
+    if (q <= 9)
+    {
+      /*
+       * The largest power of 5 that fits in 24 bits is 5^10, but q <= 9
+       * seems to be safe as well. Only one of mp, mv, and mm can be a
+       * multiple of 5, if any.
+       */
+      if (mv % 5 == 0)
+        vrIsTrailingZeros = multipleOfPowerOf5_32(mv, q);
+      else if (acceptBounds)
+        vmIsTrailingZeros = multipleOfPowerOf5_32(mm, q);
+      else
+        vp -= multipleOfPowerOf5_32(mp, q);
+    }
+  }
+  else
+  {
+    const uint32 q = log10Pow5(-e2);
+    e10 = q + e2;
+
+    const int32 i = -e2 - q;
+    const int32 k = pow5bits(i) - FLOAT_POW5_BITCOUNT;
+    int32 j = q - k;
+
+    vr = mulPow5divPow2(mv, i, j);
+    vp = mulPow5divPow2(mp, i, j);
+    vm = mulPow5divPow2(mm, i, j);
+
+    if (q != 0 && (vp - 1) / 10 <= vm / 10)
+    {
+      j = q - 1 - (pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+      lastRemovedDigit = (uint8) (mulPow5divPow2(mv, i + 1, j) % 10);
+    }
+    if (q <= 1)
+    {
+      /*
+       * {vr,vp,vm} is trailing zeros if {mv,mp,mm} has at least q trailing
+       * 0 bits. mv = 4 * m2, so it always has at least two trailing 0 bits.
+       */
+      vrIsTrailingZeros = true;
+      if (acceptBounds)
+      {
+        /* mm = mv - 1 - mmShift, so it has 1 trailing 0 bit iff mmShift == 1. */
+        vmIsTrailingZeros = mmShift == 1;
+      }
+      else
+      {
+        /* mp = mv + 2, so it always has at least one trailing 0 bit. */
+        --vp;
+      }
+    }
+    else if (q < 31)
+    {
+      vrIsTrailingZeros = multipleOfPowerOf2_32(mv, q - 1);
+    }
+  }
+
+  /*
+   * Step 4: Find the shortest decimal representation in the interval of
+   * legal representations.
+   */
+  uint32 removed = 0;
+  uint32 output;
+
+  if (vmIsTrailingZeros || vrIsTrailingZeros)
+  {
+    /* General case, which happens rarely (~4.0%). */
+    while (vp / 10 > vm / 10)
+    {
+      vmIsTrailingZeros &= vm % 10 == 0;
+      vrIsTrailingZeros &= lastRemovedDigit == 0;
+      lastRemovedDigit = (uint8) (vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vmIsTrailingZeros)
+    {
+      while (vm % 10 == 0)
+      {
+        vrIsTrailingZeros &= lastRemovedDigit == 0;
+        lastRemovedDigit = (uint8) (vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+
+    if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+    {
+      /* Round even if the exact number is .....50..0. */
+      lastRemovedDigit = 4;
+    }
+
+    /*
+     * We need to take vr + 1 if vr is outside bounds or we need to round
+     * up.
+     */
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+  }
+  else
+  {
+    /* Specialized for the common case (~96.0%). */
+    while (vp / 10 > vm / 10)
+    {
+      lastRemovedDigit = (uint8) (vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+
+    output = vr + (vr == vm || lastRemovedDigit >= 5);
+  }
+
+  floating_decimal_32 fd;
+
+  fd.exponent = e10 + removed;
+  fd.mantissa = output;
+  return fd;
+}
+
+/*
+ * Format float `num` to `ascii` in plain notation with the shortest digits to read it back, e.g. `2.3` and `1.0E10`
+ * is `10000000000.0`. An integer always has the fraction `.0`. `ascii` must have room for FLOAT_SHORTEST_DECIMAL_LEN
+ * bytes.
+ *
+ * Returns the length, not including the terminating '\0'.
+ */
+#define FLOAT_SHORTEST_DECIMAL_LEN 64
+
+int f2s_internal(char *ascii, float num)
+{
+  uint32 bits;
+
+  memcpy(&bits, &num, sizeof(bits));
+
+  const bool ieeeSign = ((bits >> (FLOAT_MANTISSA_BITS + FLOAT_EXPONENT_BITS)) & 1) != 0;
+  const uint32 ieeeMantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+  const uint32 ieeeExponent = (bits >> FLOAT_MANTISSA_BITS) & ((1u << FLOAT_EXPONENT_BITS) - 1);
+  int index = 0;
+
+  if (ieeeExponent == ((1u << FLOAT_EXPONENT_BITS) - 1u))
+  {
+    /* The same as printed by iostream. */
+    if (ieeeMantissa != 0)
+    {
+      memcpy(ascii, "nan", 4);
+      return 3;
+    }
+    if (ieeeSign)
+      ascii[index++] = '-';
+    memcpy(ascii + index, "inf", 4);
+    return index + 3;
+  }
+
+  if (ieeeSign)
+    ascii[index++] = '-';
+
+  if (ieeeExponent == 0 && ieeeMantissa == 0)
+  {
+    memcpy(ascii + index, "0.0", 4);
+    return index + 3;
+  }
+
+  const floating_decimal_32 v = f2d(ieeeMantissa, ieeeExponent);
+
+  char digits[10];
+  int olength = 0;
+
+  for (uint32 output = v.mantissa; output != 0; output /= 10)
+    digits[sizeof(digits) - 1 - olength++] = (char) ('0' + output % 10);
+
+  const char *d = digits + sizeof(digits) - olength;
+  const int point = olength + v.exponent;
+
+  if (v.exponent >= 0)
+  {
+    memcpy(ascii + index, d, olength);
+    index += olength;
+    memset(ascii + index, '0', v.exponent);
+    index += v.exponent;
+    ascii[index++] = '.';
+    ascii[index++] = '0';
+  }
+  else if (point > 0)
+  {
+    memcpy(ascii + index, d, point);
+    index += point;
+    ascii[index++] = '.';
+    memcpy(ascii + index, d + point, olength - point);
+    index += olength - point;
+  }
+  else
+  {
+    ascii[index++] = '0';
+    ascii[index++] = '.';
+    memset(ascii + index, '0', -point);
+    index += -point;
+    memcpy(ascii + index, d, olength);
+    index += olength;
+  }
+
+  Assert(index < FLOAT_SHORTEST_DECIMAL_LEN);
+  ascii[index] = '\0';
+  return index;
+}
+
+/*
+ * Parsing numbers from strings, the same as `std::stoi`, `std::stoll`, `std::stof` and `std::stod` (leading spaces are
+ * skipped and the number ends at the first char not valid), but without allocating or throwing for malformed strings.
+ */
+
+enum class ParseStatus { OK, INVALID, OUT_OF_RANGE };
+
+static inline bool IsSpace(char c) {
+  return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+static inline bool IsDigit(char c) {
+  return '0' <= c && c <= '9';
+}
+
+static inline const char *SkipSpaces(const char *p, const char *end) {
+  while (p < end && IsSpace(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+// Whether the 8 chars loaded in little-endian are all digits.
+static inline bool IsEightDigits(uint64 chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+// The value of 8 digits loaded in little-endian, by SWAR.
+static inline uint32 ParseEightDigits(uint64 chunk) {
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+          32;
+  return (uint32)chunk;
+}
+
+/*
+ * Parse the digits from `p` into `value`, 8 at a time if possible. Return the end of the digits, `overflow` is set if
+ * the value exceeds `uint64`.
+ */
+static inline const char *ParseDigits(const char *p, const char *end, uint64 &value, bool &overflow) {
+  value = 0;
+  overflow = false;
+  // No overflow for up to 16 digits by chunks.
+  for (int chunks = 0; chunks < 2 && end - p >= 8; ++chunks) {
+    uint64 chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    if (!IsEightDigits(chunk)) {
+      break;
+    }
+    value = value * 100000000ULL + ParseEightDigits(chunk);
+    p += 8;
+  }
+  for (; p < end && IsDigit(*p); ++p) {
+    overflow = overflow || __builtin_mul_overflow(value, 10, &value) || __builtin_add_overflow(value, *p - '0', &value);
+  }
+  return p;
+}
+
+template <typename T>
+static ParseStatus ParseInteger(std::string_view str, T &value) {
+  const char *p = SkipSpaces(str.data(), str.data() + str.size());
+  const char *end = str.data() + str.size();
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end || !IsDigit(*p)) {
+    return ParseStatus::INVALID;
+  }
+  uint64 magnitude;
+  bool overflow;
+  ParseDigits(p, end, magnitude, overflow);
+  using U = std::make_unsigned_t<T>;
+  const uint64 limit = (uint64)std::numeric_limits<T>::max() + negative;
+  if (overflow || magnitude > limit) {
+    return ParseStatus::OUT_OF_RANGE;
+  }
+  value = (T)(negative ? (U)(0 - (U)magnitude) : (U)magnitude);
+  return ParseStatus::OK;
+}
+
+// Max number of significant digits and max power of 10 exact in `T`, so that the quotient is correctly rounded.
+template <typename T>
+struct FastFloat;
+
+template <>
+struct FastFloat<float> {
+  static constexpr int MAX_DIGITS = 7;
+  static constexpr int MAX_SCALE = 10;
+};
+
+template <>
+struct FastFloat<double> {
+  static constexpr int MAX_DIGITS = 15;
+  static constexpr int MAX_SCALE = 22;
+};
+
+static const double FAST_POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+template <typename T>
+static ParseStatus ParseFloat(std::string_view str, T &value) {
+  const char *end = str.data() + str.size();
+  const char *p = SkipSpaces(str.data(), end);
+  const char *start = p;
+  // `std::from_chars` does not accept '+'.
+  if (p < end && *p == '+') {
+    ++p;
+    if (p < end && (*p == '+' || *p == '-')) {
+      return ParseStatus::INVALID;
+    }
+  }
+  const char *num = p;
+  bool negative = false;
+  if (p < end && *p == '-') {
+    negative = true;
+    ++p;
+  }
+  // Fast path for plain decimals of a few digits, e.g. "-123.45".
+  const char *q = p;
+  uint64 mantissa = 0;
+  int digits = 0;
+  int scale = 0;
+  for (; q < end && IsDigit(*q); ++q, ++digits) {
+    mantissa = mantissa * 10 + (*q - '0');
+  }
+  if (q < end && *q == '.') {
+    for (++q; q < end && IsDigit(*q); ++q, ++digits, ++scale) {
+      mantissa = mantissa * 10 + (*q - '0');
+    }
+  }
+  bool exponent = (q < end && (*q == 'e' || *q == 'E'));
+  if (digits > 0 && digits <= FastFloat<T>::MAX_DIGITS && scale <= FastFloat<T>::MAX_SCALE && !exponent &&
+      !(digits == 1 && mantissa == 0 && q < end && (*q == 'x' || *q == 'X'))) {
+    T v = (T)mantissa / (T)FAST_POW10[scale];
+    value = negative ? -v : v;
+    return ParseStatus::OK;
+  }
+  // Hexadecimal is rare, leave it to `strtod`.
+  if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    errno = 0;
+    std::string copy(start, end);
+    char *last;
+    double v = std::strtod(copy.c_str(), &last);
+    if (last == copy.c_str()) {
+      return ParseStatus::INVALID;
+    }
+    value = (T)v;
+    return (errno == ERANGE || std::isinf(value) != std::isinf(v)) ? ParseStatus::OUT_OF_RANGE : ParseStatus::OK;
+  }
+  auto result = std::from_chars(num, end, value, std::chars_format::general);
+  if (result.ec == std::errc::invalid_argument) {
+    return ParseStatus::INVALID;
+  }
+  if (result.ec == std::errc::result_out_of_range) {
+    return ParseStatus::OUT_OF_RANGE;
+  }
+  return ParseStatus::OK;
+}
+
+template <typename T>
+static T ParseNumber(std::string_view str) {
+  T value{};
+  ParseStatus status;
+  if constexpr (std::is_integral_v<T>) {
+    status = ParseInteger(str, value);
+  } else {
+    status = ParseFloat(str, value);
+  }
+  if (status == ParseStatus::OK) {
+    return value;
+  }
+  if (status == ParseStatus::INVALID) {
+    return 0;
+  }
+  if constexpr (std::is_same_v<T, int32_t>) {
+    throw ExceedsLimits<TYPE_INT32>();
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    throw ExceedsLimits<TYPE_INT64>();
+  } else if constexpr (std::is_same_v<T, float>) {
+    throw ExceedsLimits<TYPE_FLOAT>();
+  } else {
+    throw ExceedsLimits<TYPE_DOUBLE>();
+  }
+}
+
+template <typename D>
+void CastStrings(const String *in, D *out, const uint64_t *validity, size_t size) {
+  ForEachSelected(validity, size, [&](size_t i) { out[i] = ParseNumber<D>(*in[i]); });
+}
+
+template void CastStrings(const String *in, int32_t *out, const uint64_t *validity, size_t size);
+template void CastStrings(const String *in, int64_t *out, const uint64_t *validity, size_t size);
+template void CastStrings(const String *in, float *out, const uint64_t *validity, size_t size);
+template void CastStrings(const String *in, double *out, const uint64_t *validity, size_t size);
+
 template <>
 int32_t Cast(float v) {
   return lround(v);
@@ -1493,11 +2067,7 @@ int32_t Cast(double v) {
 
 template <>
 int32_t Cast(String v) {
-  try {
-    return std::stoi(*v);
-  } catch (const std::invalid_argument& e) {
-    return 0;
-  }
+  return ParseNumber<int32_t>(*v);
 }
 
 template <>
@@ -1517,11 +2087,7 @@ int64_t Cast(double v) {
 
 template <>
 int64_t Cast(String v) {
-  try {
-    return std::stoll(*v);
-  } catch (const std::invalid_argument& e) {
-    return 0;
-  }
+  return ParseNumber<int64_t>(*v);
 }
 
 template <>
@@ -1531,11 +2097,7 @@ int64_t Cast(DecimalP v) {
 
 template <>
 float Cast(String v) {
-  try {
-    return std::stof(*v);
-  } catch (const std::invalid_argument& e) {
-    return 0;
-  }
+  return ParseNumber<float>(*v);
 }
 
 template <>
@@ -1545,16 +2107,15 @@ float Cast(DecimalP v) {
 
 template <>
 double Cast(String v) {
-  try {
-    return std::stod(*v);
-  } catch (const std::invalid_argument& e) {
-    return 0;
-  }
+  return ParseNumber<double>(*v);
 }
 
 template <>
 double Cast(DecimalP v) {
-    return Cast<double>(String(v->toString()));
+  if (v.IsFixed()) {
+    return v.toDouble();
+  }
+  return Cast<double>(String(v.ToString()));
 }
 
 template <>
@@ -1564,12 +2125,16 @@ bool Cast(DecimalP v) {
 
 template <>
 String Cast(int32_t v) {
-  return std::to_string(v);
+  char buf[24];
+  auto result = std::to_chars(buf, buf + sizeof(buf), v);
+  return String(buf, result.ptr - buf);
 }
 
 template <>
 String Cast(int64_t v) {
-  return std::to_string(v);
+  char buf[24];
+  auto result = std::to_chars(buf, buf + sizeof(buf), v);
+  return String(buf, result.ptr - buf);
 }
 
 template <>
@@ -1577,20 +2142,6 @@ String Cast(bool v) {
   return v ? "true" : "false";
 }
 
-template <typename T>
-static String CastF(T v) {
-  // precision is 6 by default
-  // auto s = std::to_string(v);
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(15) << v;
-  auto s = ss.str();
-  s.erase(s.find_last_not_of('0') + 1);
-  if (s.back() == '.') {
-    s += '0';
-  }
-  return s;
-}
-
 static String CastFloat(float v) {
   // precision is 6 by default
   // auto s = std::to_string(v);
@@ -1617,7 +2168,9 @@ static String CastDouble(double v) {
 
 template <>
 String Cast(float v) {
-  return CastF(v);
+  char buf[FLOAT_SHORTEST_DECIMAL_LEN];
+  int len = f2s_internal(buf, v);
+  return String(buf, len);
 }
 
 template <>
@@ -1629,7 +2182,7 @@ String Cast(double v) {
 
 template <>
 String Cast(DecimalP v) {
-  return v->toString();
+  return v.ToString();
 }
 
 template <>
@@ -1647,21 +2200,73 @@ DecimalP Cast(bool v) {
   return v ? DecimalP(std::string("1")) : DecimalP(std::string("0"));
 }
 
+/**
+ * Round `v` to `scale` digits after the point, the same as formatting it in fixed notation, but from the bits directly.
+ * Return false if the result does not fit in fixed-point decimal.
+ */
+static bool DoubleToFixed(double v, int scale, DecimalP &result) {
+  if (!std::isfinite(v)) {
+    return false;
+  }
+  uint64 bits;
+  memcpy(&bits, &v, sizeof(bits));
+  const bool sign = (bits >> (DOUBLE_MANTISSA_BITS + DOUBLE_EXPONENT_BITS)) != 0;
+  const uint64 ieeeMantissa = bits & ((UINT64CONST(1) << DOUBLE_MANTISSA_BITS) - 1);
+  const int32 ieeeExponent = (int32)((bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1));
+  // v = m2 * 2^e2
+  const uint64 m2 = (ieeeExponent == 0 ? ieeeMantissa : ieeeMantissa | (UINT64CONST(1) << DOUBLE_MANTISSA_BITS));
+  const int32 e2 = (ieeeExponent == 0 ? 1 : ieeeExponent) - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS;
+  // Less than 2^100 for scale <= 14.
+  const uint128 n = (uint128)m2 * (uint128)types::Pow10(scale);
+  uint128 q;
+  if (e2 >= 0) {
+    if (e2 > 126 || (n >> (127 - e2)) != 0) {
+      return false;
+    }
+    q = n << e2;
+  } else if (-e2 >= 128) {
+    q = 0;
+  } else {
+    const int32 shift = -e2;
+    q = n >> shift;
+    const uint128 rem = n & (((uint128)1 << shift) - 1);
+    const uint128 half = (uint128)1 << (shift - 1);
+    // Round half to even, as printing does.
+    if (rem > half || (rem == half && (q & 1) != 0)) {
+      ++q;
+    }
+  }
+  if (q >> 127 != 0) {
+    return false;
+  }
+  auto unscaled = static_cast<types::int128_t>(q);
+  result = DecimalP(sign ? -unscaled : unscaled, scale).Normalize();
+  return true;
+}
+
 template <>
 DecimalP Cast(float v) {
+  DecimalP result;
+  if (DoubleToFixed(v, 6, result)) {
+    return result;
+  }
   String const f2s = CastFloat(v);
   return DecimalP(*f2s.GetPtr());
 }
 
 template <>
 DecimalP Cast(double v) {
+  DecimalP result;
+  if (DoubleToFixed(v, 14, result)) {
+    return result;
+  }
   String const d2s = CastDouble(v);
   return DecimalP(*d2s.GetPtr());
 }
 
 template <>
 DecimalP Cast(String v) {
-  return DecimalP(*v);
+  return DecimalP(std::string(*v));
 }
 
 template <>
@@ -86,6 +86,14 @@ DecimalP Cast(String v);
 template <>
 bool Cast(DecimalP v);
 
+/**
+ * @brief Parse the strings of a column into numbers, for the rows valid only.
+ *
+ * @param validity the validity bitmap of the column
+ */
+template <typename D>
+void CastStrings(const String *in, D *out, const uint64_t *validity, size_t size);
+
 template <typename D, typename S>
 D CastCheck(S v) {
   return Cast<D>(v);
@@ -0,0 +1,939 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "kernels.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(__clang__)
+#define EXPR_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace dingodb::expr::calc {
+
+namespace {
+
+// The bytes of bools for each bit of the index, to expand the bit mask of a vector comparison.
+struct MaskBytes {
+  constexpr MaskBytes() : bytes() {
+    for (unsigned i = 0; i < 256; ++i) {
+      for (unsigned b = 0; b < 8; ++b) {
+        bytes[i] |= static_cast<uint64_t>((i >> b) & 1) << (b * 8);
+      }
+    }
+  }
+
+  uint64_t bytes[256];
+};
+
+constexpr MaskBytes MASK_BYTES;
+
+template <KernelOp Op, typename T>
+inline bool ScalarCmp(T v0, T v1) {
+  if constexpr (Op == KERNEL_EQ) {
+    return v0 == v1;
+  } else if constexpr (Op == KERNEL_NE) {
+    return v0 != v1;
+  } else if constexpr (Op == KERNEL_LT) {
+    return v0 < v1;
+  } else if constexpr (Op == KERNEL_LE) {
+    return v0 <= v1;
+  } else if constexpr (Op == KERNEL_GT) {
+    return v0 > v1;
+  } else {
+    return v0 >= v1;
+  }
+}
+
+// Integers wrap as the vector instructions do, but the overflow of `int64_t` is reported as `calc::Add` does.
+template <KernelOp Op, typename T>
+inline bool ScalarArith(T v0, T v1, T &out) {
+  if constexpr (std::is_integral_v<T>) {
+    return ArithChecked<Op>(v0, v1, out) || !std::is_same_v<T, int64_t>;
+  } else {
+    if constexpr (Op == KERNEL_ADD) {
+      out = v0 + v1;
+    } else if constexpr (Op == KERNEL_SUB) {
+      out = v0 - v1;
+    } else {
+      out = v0 * v1;
+    }
+    return true;
+  }
+}
+
+// Cast the rows from `begin` one by one, where `ok` is whether the rows before are in range.
+template <KernelOp Op, typename D, typename S>
+inline bool CastLoop(const S *in, D *out, size_t size, size_t begin = 0, bool ok = true) {
+  for (size_t i = begin; i < size; ++i) {
+    ok &= CastInRange(in[i], out[i]);
+  }
+  if (ok) {
+    return true;
+  }
+  if constexpr (Op == KERNEL_CAST_CHECK) {
+    return false;
+  } else {
+    // Out of range is rare, cast them exactly as `calc::Cast` does.
+    if constexpr (std::is_floating_point_v<S>) {
+      for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<D>(std::llround(in[i]));
+      }
+    }
+    return true;
+  }
+}
+
+namespace scalar {
+
+template <KernelOp Op, typename D, typename S>
+bool CastKernel(const S *in, D *out, size_t size) {
+  return CastLoop<Op>(in, out, size);
+}
+
+template <KernelOp Op, typename T>
+bool CmpKernel(const T *v0, const T *v1, bool *out, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = ScalarCmp<Op>(v0[i], v1[i]);
+  }
+  return true;
+}
+
+template <KernelOp Op, typename T>
+bool CmpConstKernel(const T *v0, T v1, bool *out, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = ScalarCmp<Op>(v0[i], v1);
+  }
+  return true;
+}
+
+template <KernelOp Op, typename T>
+bool ArithKernel(const T *v0, const T *v1, T *out, size_t size) {
+  bool ok = true;
+  for (size_t i = 0; i < size; ++i) {
+    ok &= ScalarArith<Op>(v0[i], v1[i], out[i]);
+  }
+  return ok;
+}
+
+template <KernelOp Op, typename T>
+bool ArithConstKernel(const T *v0, T v1, T *out, size_t size) {
+  bool ok = true;
+  for (size_t i = 0; i < size; ++i) {
+    ok &= ScalarArith<Op>(v0[i], v1, out[i]);
+  }
+  return ok;
+}
+
+}  // namespace scalar
+
+#ifdef EXPR_KERNELS_X86
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<int32_t> {
+  using V = __m256i;
+  static constexpr size_t LANES = 8;
+
+  static V Load(const int32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+
+  static void Store(int32_t *p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+
+  static V Set1(int32_t v) {
+    return _mm256_set1_epi32(v);
+  }
+
+  static V Zero() {
+    return _mm256_setzero_si256();
+  }
+
+  static V Eq(V a, V b) {
+    return _mm256_cmpeq_epi32(a, b);
+  }
+
+  static V Gt(V a, V b) {
+    return _mm256_cmpgt_epi32(a, b);
+  }
+
+  static unsigned MoveMask(V v) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(v));
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b);
+
+  static V Add(V a, V b) {
+    return _mm256_add_epi32(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm256_sub_epi32(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm256_mullo_epi32(a, b);
+  }
+};
+
+template <>
+struct Vec<int64_t> {
+  using V = __m256i;
+  static constexpr size_t LANES = 4;
+
+  static V Load(const int64_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+
+  static void Store(int64_t *p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+
+  static V Set1(int64_t v) {
+    return _mm256_set1_epi64x(v);
+  }
+
+  static V Zero() {
+    return _mm256_setzero_si256();
+  }
+
+  static V Eq(V a, V b) {
+    return _mm256_cmpeq_epi64(a, b);
+  }
+
+  static V Gt(V a, V b) {
+    return _mm256_cmpgt_epi64(a, b);
+  }
+
+  static unsigned MoveMask(V v) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(v));
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b);
+
+  static V Add(V a, V b) {
+    return _mm256_add_epi64(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm256_sub_epi64(a, b);
+  }
+
+  static V Or(V a, V b) {
+    return _mm256_or_si256(a, b);
+  }
+
+  // The sign bits are set for the overflowed lanes.
+  template <KernelOp Op>
+  static V Overflow(V a, V b, V r) {
+    if constexpr (Op == KERNEL_ADD) {
+      return _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r));
+    } else {
+      return _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r));
+    }
+  }
+
+  static bool Any(V v) {
+    return MoveMask(v) != 0;
+  }
+};
+
+template <>
+struct Vec<float> {
+  using V = __m256;
+  static constexpr size_t LANES = 8;
+
+  static V Load(const float *p) {
+    return _mm256_loadu_ps(p);
+  }
+
+  static void Store(float *p, V v) {
+    _mm256_storeu_ps(p, v);
+  }
+
+  static V Set1(float v) {
+    return _mm256_set1_ps(v);
+  }
+
+  static V Zero() {
+    return _mm256_setzero_ps();
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(a, b, Predicate<Op>()));
+  }
+
+  template <KernelOp Op>
+  static constexpr int Predicate() {
+    if constexpr (Op == KERNEL_EQ) {
+      return _CMP_EQ_OQ;
+    } else if constexpr (Op == KERNEL_NE) {
+      return _CMP_NEQ_UQ;
+    } else if constexpr (Op == KERNEL_LT) {
+      return _CMP_LT_OQ;
+    } else if constexpr (Op == KERNEL_LE) {
+      return _CMP_LE_OQ;
+    } else if constexpr (Op == KERNEL_GT) {
+      return _CMP_GT_OQ;
+    } else {
+      return _CMP_GE_OQ;
+    }
+  }
+
+  static V Add(V a, V b) {
+    return _mm256_add_ps(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm256_sub_ps(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm256_mul_ps(a, b);
+  }
+};
+
+template <>
+struct Vec<double> {
+  using V = __m256d;
+  static constexpr size_t LANES = 4;
+
+  static V Load(const double *p) {
+    return _mm256_loadu_pd(p);
+  }
+
+  static void Store(double *p, V v) {
+    _mm256_storeu_pd(p, v);
+  }
+
+  static V Set1(double v) {
+    return _mm256_set1_pd(v);
+  }
+
+  static V Zero() {
+    return _mm256_setzero_pd();
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, Vec<float>::Predicate<Op>()));
+  }
+
+  static V Add(V a, V b) {
+    return _mm256_add_pd(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm256_sub_pd(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm256_mul_pd(a, b);
+  }
+};
+
+// Cast `LANES` values, return false if any is out of range. Only the narrowing casts, which are checked, are specialized,
+// for the widening ones are vectorized well by the compiler.
+template <typename D, typename S>
+struct CastVec {
+  static constexpr size_t LANES = 0;
+};
+
+template <>
+struct CastVec<int32_t, int64_t> {
+  static constexpr size_t LANES = 4;
+
+  static bool Cast(const int64_t *in, int32_t *out) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    auto low = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), low);
+    // In range if sign extending gets the same values.
+    auto eq = _mm256_cmpeq_epi64(_mm256_cvtepi32_epi64(low), v);
+    return _mm256_movemask_pd(_mm256_castsi256_pd(eq)) == 0xF;
+  }
+};
+
+// Rounding half away from zero as `lround`, the same as `CastInRange`.
+template <>
+struct CastVec<int32_t, double> {
+  static constexpr size_t LANES = 4;
+
+  static bool Cast(const double *in, int32_t *out) {
+    auto v = _mm256_loadu_pd(in);
+    auto sign = _mm256_set1_pd(-0.0);
+    auto t = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto half = _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(v, t)), _mm256_set1_pd(0.5), _CMP_GE_OQ);
+    auto one = _mm256_or_pd(_mm256_and_pd(half, _mm256_set1_pd(1.0)), _mm256_and_pd(v, sign));
+    t = _mm256_add_pd(t, one);
+    auto in_range = _mm256_and_pd(_mm256_cmp_pd(t, _mm256_set1_pd(-2147483648.0), _CMP_GE_OQ),
+                                  _mm256_cmp_pd(t, _mm256_set1_pd(2147483648.0), _CMP_LT_OQ));
+    t = _mm256_and_pd(t, in_range);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_cvttpd_epi32(t));
+    return _mm256_movemask_pd(in_range) == 0xF;
+  }
+};
+
+template <>
+struct CastVec<int32_t, float> {
+  static constexpr size_t LANES = 8;
+
+  static bool Cast(const float *in, int32_t *out) {
+    auto v = _mm256_loadu_ps(in);
+    auto sign = _mm256_set1_ps(-0.0f);
+    auto t = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto half = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(v, t)), _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    auto one = _mm256_or_ps(_mm256_and_ps(half, _mm256_set1_ps(1.0f)), _mm256_and_ps(v, sign));
+    t = _mm256_add_ps(t, one);
+    auto in_range = _mm256_and_ps(_mm256_cmp_ps(t, _mm256_set1_ps(-2147483648.0f), _CMP_GE_OQ),
+                                  _mm256_cmp_ps(t, _mm256_set1_ps(2147483648.0f), _CMP_LT_OQ));
+    t = _mm256_and_ps(t, in_range);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvttps_epi32(t));
+    return _mm256_movemask_ps(in_range) == 0xFF;
+  }
+};
+
+#include "kernels_simd.inc"
+
+template <KernelOp Op>
+unsigned Vec<int32_t>::Cmp(V a, V b) {
+  return IntCmp<Op, Vec<int32_t>>(a, b);
+}
+
+template <KernelOp Op>
+unsigned Vec<int64_t>::Cmp(V a, V b) {
+  return IntCmp<Op, Vec<int64_t>>(a, b);
+}
+
+}  // namespace avx2
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+namespace sse42 {
+
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<int32_t> {
+  using V = __m128i;
+  static constexpr size_t LANES = 4;
+
+  static V Load(const int32_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+
+  static void Store(int32_t *p, V v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+
+  static V Set1(int32_t v) {
+    return _mm_set1_epi32(v);
+  }
+
+  static V Zero() {
+    return _mm_setzero_si128();
+  }
+
+  static V Eq(V a, V b) {
+    return _mm_cmpeq_epi32(a, b);
+  }
+
+  static V Gt(V a, V b) {
+    return _mm_cmpgt_epi32(a, b);
+  }
+
+  static unsigned MoveMask(V v) {
+    return _mm_movemask_ps(_mm_castsi128_ps(v));
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b);
+
+  static V Add(V a, V b) {
+    return _mm_add_epi32(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm_sub_epi32(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm_mullo_epi32(a, b);
+  }
+};
+
+template <>
+struct Vec<int64_t> {
+  using V = __m128i;
+  static constexpr size_t LANES = 2;
+
+  static V Load(const int64_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+
+  static void Store(int64_t *p, V v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+
+  static V Set1(int64_t v) {
+    return _mm_set1_epi64x(v);
+  }
+
+  static V Zero() {
+    return _mm_setzero_si128();
+  }
+
+  static V Eq(V a, V b) {
+    return _mm_cmpeq_epi64(a, b);
+  }
+
+  static V Gt(V a, V b) {
+    return _mm_cmpgt_epi64(a, b);
+  }
+
+  static unsigned MoveMask(V v) {
+    return _mm_movemask_pd(_mm_castsi128_pd(v));
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b);
+
+  static V Add(V a, V b) {
+    return _mm_add_epi64(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm_sub_epi64(a, b);
+  }
+
+  static V Or(V a, V b) {
+    return _mm_or_si128(a, b);
+  }
+
+  // The sign bits are set for the overflowed lanes.
+  template <KernelOp Op>
+  static V Overflow(V a, V b, V r) {
+    if constexpr (Op == KERNEL_ADD) {
+      return _mm_and_si128(_mm_xor_si128(a, r), _mm_xor_si128(b, r));
+    } else {
+      return _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r));
+    }
+  }
+
+  static bool Any(V v) {
+    return MoveMask(v) != 0;
+  }
+};
+
+template <>
+struct Vec<float> {
+  using V = __m128;
+  static constexpr size_t LANES = 4;
+
+  static V Load(const float *p) {
+    return _mm_loadu_ps(p);
+  }
+
+  static void Store(float *p, V v) {
+    _mm_storeu_ps(p, v);
+  }
+
+  static V Set1(float v) {
+    return _mm_set1_ps(v);
+  }
+
+  static V Zero() {
+    return _mm_setzero_ps();
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b) {
+    if constexpr (Op == KERNEL_EQ) {
+      return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+    } else if constexpr (Op == KERNEL_NE) {
+      return _mm_movemask_ps(_mm_cmpneq_ps(a, b));
+    } else if constexpr (Op == KERNEL_LT) {
+      return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+    } else if constexpr (Op == KERNEL_LE) {
+      return _mm_movemask_ps(_mm_cmple_ps(a, b));
+    } else if constexpr (Op == KERNEL_GT) {
+      return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+    } else {
+      return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+    }
+  }
+
+  static V Add(V a, V b) {
+    return _mm_add_ps(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm_sub_ps(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm_mul_ps(a, b);
+  }
+};
+
+template <>
+struct Vec<double> {
+  using V = __m128d;
+  static constexpr size_t LANES = 2;
+
+  static V Load(const double *p) {
+    return _mm_loadu_pd(p);
+  }
+
+  static void Store(double *p, V v) {
+    _mm_storeu_pd(p, v);
+  }
+
+  static V Set1(double v) {
+    return _mm_set1_pd(v);
+  }
+
+  static V Zero() {
+    return _mm_setzero_pd();
+  }
+
+  template <KernelOp Op>
+  static unsigned Cmp(V a, V b) {
+    if constexpr (Op == KERNEL_EQ) {
+      return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+    } else if constexpr (Op == KERNEL_NE) {
+      return _mm_movemask_pd(_mm_cmpneq_pd(a, b));
+    } else if constexpr (Op == KERNEL_LT) {
+      return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+    } else if constexpr (Op == KERNEL_LE) {
+      return _mm_movemask_pd(_mm_cmple_pd(a, b));
+    } else if constexpr (Op == KERNEL_GT) {
+      return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+    } else {
+      return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+    }
+  }
+
+  static V Add(V a, V b) {
+    return _mm_add_pd(a, b);
+  }
+
+  static V Sub(V a, V b) {
+    return _mm_sub_pd(a, b);
+  }
+
+  static V Mul(V a, V b) {
+    return _mm_mul_pd(a, b);
+  }
+};
+
+// Cast `LANES` values, return false if any is out of range. Only the narrowing casts, which are checked, are specialized,
+// for the widening ones are vectorized well by the compiler.
+template <typename D, typename S>
+struct CastVec {
+  static constexpr size_t LANES = 0;
+};
+
+template <>
+struct CastVec<int32_t, int64_t> {
+  static constexpr size_t LANES = 2;
+
+  static bool Cast(const int64_t *in, int32_t *out) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    auto low = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), low);
+    // In range if sign extending gets the same values.
+    auto eq = _mm_cmpeq_epi64(_mm_cvtepi32_epi64(low), v);
+    return _mm_movemask_pd(_mm_castsi128_pd(eq)) == 0x3;
+  }
+};
+
+// Rounding half away from zero as `lround`, the same as `CastInRange`.
+template <>
+struct CastVec<int32_t, double> {
+  static constexpr size_t LANES = 2;
+
+  static bool Cast(const double *in, int32_t *out) {
+    auto v = _mm_loadu_pd(in);
+    auto sign = _mm_set1_pd(-0.0);
+    auto t = _mm_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto half = _mm_cmpge_pd(_mm_andnot_pd(sign, _mm_sub_pd(v, t)), _mm_set1_pd(0.5));
+    auto one = _mm_or_pd(_mm_and_pd(half, _mm_set1_pd(1.0)), _mm_and_pd(v, sign));
+    t = _mm_add_pd(t, one);
+    auto in_range = _mm_and_pd(_mm_cmpge_pd(t, _mm_set1_pd(-2147483648.0)), _mm_cmplt_pd(t, _mm_set1_pd(2147483648.0)));
+    t = _mm_and_pd(t, in_range);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_cvttpd_epi32(t));
+    return _mm_movemask_pd(in_range) == 0x3;
+  }
+};
+
+template <>
+struct CastVec<int32_t, float> {
+  static constexpr size_t LANES = 4;
+
+  static bool Cast(const float *in, int32_t *out) {
+    auto v = _mm_loadu_ps(in);
+    auto sign = _mm_set1_ps(-0.0f);
+    auto t = _mm_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto half = _mm_cmpge_ps(_mm_andnot_ps(sign, _mm_sub_ps(v, t)), _mm_set1_ps(0.5f));
+    auto one = _mm_or_ps(_mm_and_ps(half, _mm_set1_ps(1.0f)), _mm_and_ps(v, sign));
+    t = _mm_add_ps(t, one);
+    auto in_range =
+        _mm_and_ps(_mm_cmpge_ps(t, _mm_set1_ps(-2147483648.0f)), _mm_cmplt_ps(t, _mm_set1_ps(2147483648.0f)));
+    t = _mm_and_ps(t, in_range);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvttps_epi32(t));
+    return _mm_movemask_ps(in_range) == 0xF;
+  }
+};
+
+#include "kernels_simd.inc"
+
+template <KernelOp Op>
+unsigned Vec<int32_t>::Cmp(V a, V b) {
+  return IntCmp<Op, Vec<int32_t>>(a, b);
+}
+
+template <KernelOp Op>
+unsigned Vec<int64_t>::Cmp(V a, V b) {
+  return IntCmp<Op, Vec<int64_t>>(a, b);
+}
+
+}  // namespace sse42
+
+#pragma GCC pop_options
+
+#endif  // EXPR_KERNELS_X86
+
+// There is no vector instruction to multiply `int64_t` before AVX-512.
+template <KernelOp Op, typename T>
+constexpr bool HasVectorKernel() {
+  return !(Op == KERNEL_MUL && std::is_same_v<T, int64_t>);
+}
+
+template <KernelOp Op, typename T>
+Kernel<bool, T> CmpKernelOf([[maybe_unused]] KernelLevel level) {
+#ifdef EXPR_KERNELS_X86
+  if (level >= KERNEL_AVX2) {
+    return avx2::CmpKernel<Op, T>;
+  }
+  if (level >= KERNEL_SSE42) {
+    return sse42::CmpKernel<Op, T>;
+  }
+#endif
+  return scalar::CmpKernel<Op, T>;
+}
+
+template <KernelOp Op, typename T>
+ConstKernel<bool, T> CmpConstKernelOf([[maybe_unused]] KernelLevel level) {
+#ifdef EXPR_KERNELS_X86
+  if (level >= KERNEL_AVX2) {
+    return avx2::CmpConstKernel<Op, T>;
+  }
+  if (level >= KERNEL_SSE42) {
+    return sse42::CmpConstKernel<Op, T>;
+  }
+#endif
+  return scalar::CmpConstKernel<Op, T>;
+}
+
+template <KernelOp Op, typename T>
+Kernel<T, T> ArithKernelOf([[maybe_unused]] KernelLevel level) {
+#ifdef EXPR_KERNELS_X86
+  if constexpr (HasVectorKernel<Op, T>()) {
+    if (level >= KERNEL_AVX2) {
+      return avx2::ArithKernel<Op, T>;
+    }
+    if (level >= KERNEL_SSE42) {
+      return sse42::ArithKernel<Op, T>;
+    }
+  }
+#endif
+  return scalar::ArithKernel<Op, T>;
+}
+
+template <KernelOp Op, typename T>
+ConstKernel<T, T> ArithConstKernelOf([[maybe_unused]] KernelLevel level) {
+#ifdef EXPR_KERNELS_X86
+  if constexpr (HasVectorKernel<Op, T>()) {
+    if (level >= KERNEL_AVX2) {
+      return avx2::ArithConstKernel<Op, T>;
+    }
+    if (level >= KERNEL_SSE42) {
+      return sse42::ArithConstKernel<Op, T>;
+    }
+  }
+#endif
+  return scalar::ArithConstKernel<Op, T>;
+}
+
+template <KernelOp Op, typename D, typename S>
+CastKernel<D, S> CastKernelOf([[maybe_unused]] KernelLevel level) {
+#ifdef EXPR_KERNELS_X86
+  if (level >= KERNEL_AVX2) {
+    return avx2::CastKernel<Op, D, S>;
+  }
+  if (level >= KERNEL_SSE42) {
+    return sse42::CastKernel<Op, D, S>;
+  }
+#endif
+  return scalar::CastKernel<Op, D, S>;
+}
+
+}  // namespace
+
+KernelLevel GetKernelLevel() {
+#ifdef EXPR_KERNELS_X86
+  static const KernelLevel LEVEL = __builtin_cpu_supports("avx2")     ? KERNEL_AVX2
+                                   : __builtin_cpu_supports("sse4.2") ? KERNEL_SSE42
+                                                                      : KERNEL_SCALAR;
+  return LEVEL;
+#else
+  return KERNEL_SCALAR;
+#endif
+}
+
+template <typename R, typename T>
+Kernel<R, T> GetKernel(KernelOp op, KernelLevel level) {
+  if constexpr (std::is_same_v<R, bool>) {
+    switch (op) {
+    case KERNEL_EQ:
+      return CmpKernelOf<KERNEL_EQ, T>(level);
+    case KERNEL_NE:
+      return CmpKernelOf<KERNEL_NE, T>(level);
+    case KERNEL_LT:
+      return CmpKernelOf<KERNEL_LT, T>(level);
+    case KERNEL_LE:
+      return CmpKernelOf<KERNEL_LE, T>(level);
+    case KERNEL_GT:
+      return CmpKernelOf<KERNEL_GT, T>(level);
+    case KERNEL_GE:
+      return CmpKernelOf<KERNEL_GE, T>(level);
+    default:
+      return nullptr;
+    }
+  } else {
+    switch (op) {
+    case KERNEL_ADD:
+      return ArithKernelOf<KERNEL_ADD, T>(level);
+    case KERNEL_SUB:
+      return ArithKernelOf<KERNEL_SUB, T>(level);
+    case KERNEL_MUL:
+      return ArithKernelOf<KERNEL_MUL, T>(level);
+    default:
+      return nullptr;
+    }
+  }
+}
+
+template <typename R, typename T>
+ConstKernel<R, T> GetConstKernel(KernelOp op, KernelLevel level) {
+  if constexpr (std::is_same_v<R, bool>) {
+    switch (op) {
+    case KERNEL_EQ:
+      return CmpConstKernelOf<KERNEL_EQ, T>(level);
+    case KERNEL_NE:
+      return CmpConstKernelOf<KERNEL_NE, T>(level);
+    case KERNEL_LT:
+      return CmpConstKernelOf<KERNEL_LT, T>(level);
+    case KERNEL_LE:
+      return CmpConstKernelOf<KERNEL_LE, T>(level);
+    case KERNEL_GT:
+      return CmpConstKernelOf<KERNEL_GT, T>(level);
+    case KERNEL_GE:
+      return CmpConstKernelOf<KERNEL_GE, T>(level);
+    default:
+      return nullptr;
+    }
+  } else {
+    switch (op) {
+    case KERNEL_ADD:
+      return ArithConstKernelOf<KERNEL_ADD, T>(level);
+    case KERNEL_SUB:
+      return ArithConstKernelOf<KERNEL_SUB, T>(level);
+    case KERNEL_MUL:
+      return ArithConstKernelOf<KERNEL_MUL, T>(level);
+    default:
+      return nullptr;
+    }
+  }
+}
+
+template Kernel<bool, int32_t> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<bool, int64_t> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<bool, float> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<bool, double> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<int32_t, int32_t> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<int64_t, int64_t> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<float, float> GetKernel(KernelOp op, KernelLevel level);
+template Kernel<double, double> GetKernel(KernelOp op, KernelLevel level);
+
+template ConstKernel<bool, int32_t> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<bool, int64_t> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<bool, float> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<bool, double> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<int32_t, int32_t> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<int64_t, int64_t> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<float, float> GetConstKernel(KernelOp op, KernelLevel level);
+template ConstKernel<double, double> GetConstKernel(KernelOp op, KernelLevel level);
+
+template <typename D, typename S>
+CastKernel<D, S> GetCastKernel(KernelOp op, KernelLevel level) {
+  switch (op) {
+  case KERNEL_CAST:
+    return CastKernelOf<KERNEL_CAST, D, S>(level);
+  case KERNEL_CAST_CHECK:
+    return CastKernelOf<KERNEL_CAST_CHECK, D, S>(level);
+  default:
+    return nullptr;
+  }
+}
+
+template CastKernel<bool, int32_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<bool, int64_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<bool, float> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<bool, double> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int32_t, bool> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int32_t, int64_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int32_t, float> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int32_t, double> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int64_t, bool> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int64_t, int32_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int64_t, float> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<int64_t, double> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<float, bool> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<float, int32_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<float, int64_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<float, double> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<double, bool> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<double, int32_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<double, int64_t> GetCastKernel(KernelOp op, KernelLevel level);
+template CastKernel<double, float> GetCastKernel(KernelOp op, KernelLevel level);
+
+}  // namespace dingodb::expr::calc
@@ -0,0 +1,238 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_CALC_KERNELS_H_
+#define _EXPR_CALC_KERNELS_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "arithmetic.h"
+#include "casting.h"
+#include "relational.h"
+
+namespace dingodb::expr::calc {
+
+enum KernelOp {
+  KERNEL_NONE,
+  KERNEL_EQ,
+  KERNEL_NE,
+  KERNEL_LT,
+  KERNEL_LE,
+  KERNEL_GT,
+  KERNEL_GE,
+  KERNEL_ADD,
+  KERNEL_SUB,
+  KERNEL_MUL,
+  KERNEL_CAST,
+  KERNEL_CAST_CHECK,
+};
+
+enum KernelLevel {
+  KERNEL_SCALAR,
+  KERNEL_SSE42,
+  KERNEL_AVX2,
+};
+
+/**
+ * @brief A kernel evaluating over whole vectors, for batch evaluating.
+ *
+ * The values are computed for all the elements regardless of nulls, the validity is combined by the caller.
+ *
+ * @return false if any result of `int64_t` overflows, then nothing can be assumed about `out`
+ */
+template <typename R, typename T>
+using Kernel = bool (*)(const T *v0, const T *v1, R *out, size_t size);
+
+/**
+ * @brief The same as `Kernel`, but the second operand is a constant.
+ */
+template <typename R, typename T>
+using ConstKernel = bool (*)(const T *v0, T v1, R *out, size_t size);
+
+/**
+ * @brief A kernel casting whole vectors, for batch evaluating.
+ *
+ * @return false if any value is out of range of `D` for a checked cast, then nothing can be assumed about `out`
+ */
+template <typename D, typename S>
+using CastKernel = bool (*)(const S *in, D *out, size_t size);
+
+/**
+ * @brief Get the highest instruction set supported by the running CPU.
+ */
+KernelLevel GetKernelLevel();
+
+/**
+ * @brief Get the kernel of an operation, for the instruction set specified or the highest one supported.
+ *
+ * Comparisons are of type `Kernel<bool, T>` and arithmetic operations are of type `Kernel<T, T>`, where `T` is one of
+ * `int32_t`, `int64_t`, `float` and `double`.
+ */
+template <typename R, typename T>
+Kernel<R, T> GetKernel(KernelOp op, KernelLevel level = GetKernelLevel());
+
+template <typename R, typename T>
+ConstKernel<R, T> GetConstKernel(KernelOp op, KernelLevel level = GetKernelLevel());
+
+/**
+ * @brief Get the kernel of `KERNEL_CAST` or `KERNEL_CAST_CHECK`, where `D` and `S` are different types of `bool`,
+ * `int32_t`, `int64_t`, `float` and `double`.
+ */
+template <typename D, typename S>
+CastKernel<D, S> GetCastKernel(KernelOp op, KernelLevel level = GetKernelLevel());
+
+template <typename T>
+constexpr bool IsKernelType() {
+  return std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, float> ||
+         std::is_same_v<T, double>;
+}
+
+/**
+ * @brief The operation of a calc function given as the template argument, `KERNEL_NONE` if it is none of them.
+ *
+ * The functions are matched by specializing on them, for comparing function pointers is not a constant expression for
+ * every compiler, e.g. GCC with `-fsanitize=undefined`.
+ */
+template <auto Calc>
+struct CalcOp {
+  static constexpr KernelOp OP = KERNEL_NONE;
+};
+
+#define DEFINE_CALC_OP(FUN, KERNEL_OP)        \
+  template <>                                 \
+  struct CalcOp<FUN> {                        \
+    static constexpr KernelOp OP = KERNEL_OP; \
+  };
+
+#define DEFINE_CALC_OPS_OF_TYPE(T)    \
+  DEFINE_CALC_OP(Eq<T>, KERNEL_EQ)    \
+  DEFINE_CALC_OP(Ne<T>, KERNEL_NE)    \
+  DEFINE_CALC_OP(Lt<T>, KERNEL_LT)    \
+  DEFINE_CALC_OP(Le<T>, KERNEL_LE)    \
+  DEFINE_CALC_OP(Gt<T>, KERNEL_GT)    \
+  DEFINE_CALC_OP(Ge<T>, KERNEL_GE)    \
+  DEFINE_CALC_OP(Add<T>, KERNEL_ADD)  \
+  DEFINE_CALC_OP(Sub<T>, KERNEL_SUB)  \
+  DEFINE_CALC_OP(Mul<T>, KERNEL_MUL)
+
+DEFINE_CALC_OPS_OF_TYPE(int32_t)
+DEFINE_CALC_OPS_OF_TYPE(int64_t)
+DEFINE_CALC_OPS_OF_TYPE(float)
+DEFINE_CALC_OPS_OF_TYPE(double)
+
+#define DEFINE_CAST_OPS(D, S)               \
+  DEFINE_CALC_OP((Cast<D, S>), KERNEL_CAST) \
+  DEFINE_CALC_OP((CastCheck<D, S>), KERNEL_CAST_CHECK)
+
+#define DEFINE_CAST_OPS_TO(D, S0, S1, S2, S3) \
+  DEFINE_CAST_OPS(D, S0)                      \
+  DEFINE_CAST_OPS(D, S1)                      \
+  DEFINE_CAST_OPS(D, S2)                      \
+  DEFINE_CAST_OPS(D, S3)
+
+DEFINE_CAST_OPS_TO(bool, int32_t, int64_t, float, double)
+DEFINE_CAST_OPS_TO(int32_t, bool, int64_t, float, double)
+DEFINE_CAST_OPS_TO(int64_t, bool, int32_t, float, double)
+DEFINE_CAST_OPS_TO(float, bool, int32_t, int64_t, double)
+DEFINE_CAST_OPS_TO(double, bool, int32_t, int64_t, float)
+
+// Casting strings to numbers has no kernel, but is done by `CastStrings`.
+DEFINE_CALC_OP((Cast<int32_t, String>), KERNEL_CAST)
+DEFINE_CALC_OP((Cast<int64_t, String>), KERNEL_CAST)
+DEFINE_CALC_OP((Cast<float, String>), KERNEL_CAST)
+DEFINE_CALC_OP((Cast<double, String>), KERNEL_CAST)
+
+#undef DEFINE_CAST_OPS_TO
+#undef DEFINE_CAST_OPS
+#undef DEFINE_CALC_OPS_OF_TYPE
+#undef DEFINE_CALC_OP
+
+/**
+ * @brief Get the kernel operation of a calc function, `KERNEL_NONE` if there is no kernel for it.
+ */
+template <typename R, typename T0, typename T1, R (*Calc)(T0, T1)>
+constexpr KernelOp KernelOpOf() {
+  constexpr auto OP = CalcOp<Calc>::OP;
+  if constexpr (std::is_same_v<T0, T1> && IsKernelType<T0>()) {
+    if constexpr (std::is_same_v<R, bool>) {
+      return (KERNEL_EQ <= OP && OP <= KERNEL_GE) ? OP : KERNEL_NONE;
+    } else if constexpr (std::is_same_v<R, T0>) {
+      return (KERNEL_ADD <= OP && OP <= KERNEL_MUL) ? OP : KERNEL_NONE;
+    }
+  }
+  return KERNEL_NONE;
+}
+
+/**
+ * @brief Get the kernel operation of a cast function, `KERNEL_NONE` if there is no kernel for it.
+ */
+template <typename D, typename S, D (*Calc)(S)>
+constexpr KernelOp CastKernelOpOf() {
+  if constexpr (!std::is_same_v<D, S> && (IsKernelType<D>() || std::is_same_v<D, bool>) &&
+                (IsKernelType<S>() || std::is_same_v<S, bool>)) {
+    return CalcOp<Calc>::OP;
+  }
+  return KERNEL_NONE;
+}
+
+/**
+ * @brief Cast a value the same as `calc::Cast`, but without calling libm, so that it can be vectorized.
+ *
+ * Floating-point values are rounded half away from zero to integers, as `lround` does.
+ *
+ * @return false if the value is out of range of `D`, then `out` is 0, or wrapped for integers
+ */
+template <typename D, typename S>
+inline bool CastInRange(S v, D &out) {
+  if constexpr (std::is_integral_v<D> && !std::is_same_v<D, bool> && std::is_floating_point_v<S>) {
+    S t = std::trunc(v);
+    // No branches, to be vectorized.
+    t += std::copysign(static_cast<S>(std::fabs(v - t) >= static_cast<S>(0.5)), v);
+    constexpr auto MIN = static_cast<S>(std::numeric_limits<D>::min());
+    // `-MIN` is exact, but `MAX` may be not.
+    bool in_range = (MIN <= t) & (t < -MIN);
+    out = static_cast<D>(in_range ? t : 0);
+    return in_range;
+  } else if constexpr (std::is_same_v<D, int32_t> && std::is_same_v<S, int64_t>) {
+    out = static_cast<D>(v);
+    return out == v;
+  } else {
+    out = static_cast<D>(v);
+    return true;
+  }
+}
+
+/**
+ * @brief Compute an arithmetic operation of integers without throwing.
+ *
+ * @return false if the result overflows, then `out` is wrapped
+ */
+template <KernelOp Op, typename T>
+inline bool ArithChecked(T v0, T v1, T &out) {
+  if constexpr (Op == KERNEL_ADD) {
+    return AddChecked(v0, v1, out);
+  } else if constexpr (Op == KERNEL_SUB) {
+    return SubChecked(v0, v1, out);
+  } else {
+    return MulChecked(v0, v1, out);
+  }
+}
+
+}  // namespace dingodb::expr::calc
+
+#endif /* _EXPR_CALC_KERNELS_H_ */
@@ -22,7 +22,7 @@ namespace dingodb::expr::calc {
 String Concat(String v0, String v1) {
   if (!v0->empty()) {
     if (!v1->empty()) {
-      return *v0 + *v1;
+      return v0 + v1;
     }
     return v0;
   }
@@ -46,7 +46,7 @@ String Left(String v0, int32_t v1) {
     if (v1 > 0) {
       auto len = v0->length();
       if (v1 < len) {
-        return v0->substr(0, v1);
+        return v0.Slice(0, v1);
       }
       return v0;
     }
@@ -60,7 +60,7 @@ String Right(String v0, int32_t v1) {
     if (v1 > 0) {
       auto len = v0->length();
       if (v1 < len) {
-        return v0->substr(len - v1);
+        return v0.Slice(len - v1);
       }
       return v0;
     }
@@ -76,17 +76,17 @@ static bool IsSpace(unsigned char ch) {
 String Trim(String v) {
   auto s = std::find_if_not(v->cbegin(), v->cend(), IsSpace);
   auto e = std::find_if_not(v->crbegin(), v->crend(), IsSpace);
-  return v->substr(s - v->cbegin(), (v->crend() - e) - (s - v->cbegin()));
+  return v.Slice(s - v->cbegin(), (v->crend() - e) - (s - v->cbegin()));
 }
 
 String LTrim(String v) {
   auto s = std::find_if_not(v->cbegin(), v->cend(), IsSpace);
-  return v->substr(s - v->cbegin());
+  return v.Slice(s - v->cbegin());
 }
 
 String RTrim(String v) {
   auto e = std::find_if_not(v->crbegin(), v->crend(), IsSpace);
-  return v->substr(0, v->crend() - e);
+  return v.Slice(0, v->crend() - e);
 }
 
 String Substr(String v0, int32_t v1, int32_t v2) {
@@ -98,13 +98,13 @@ String Substr(String v0, int32_t v1, int32_t v2) {
     if (v2 >= len) {
       return v0;
     } else {
-      return v0->substr(v1, v2 - v1);
+      return v0.Slice(v1, v2 - v1);
     }
   } else {
     if (v2 >= len) {
-      return v0->substr(v1);
+      return v0.Slice(v1);
     } else {
-      return v0->substr(v1, v2 - v1);
+      return v0.Slice(v1, v2 - v1);
     }
   }
 }
@@ -117,7 +117,7 @@ String Substr(String v0, int32_t v1) {
   if (v1 == 0) {
     return v0;
   } else {
-    return v0->substr(v1);
+    return v0.Slice(v1);
   }
 }
 
@@ -136,9 +136,9 @@ String Mid(String v0, int32_t v1, int32_t v2) {
       return String();
     }
     if (v1 + v2 >= len) {
-      return v0->substr(v1);
+      return v0.Slice(v1);
     } else {
-      return v0->substr(v1, v2);
+      return v0.Slice(v1, v2);
     }
   }
   return String();
@@ -153,7 +153,7 @@ String Mid(String v0, int32_t v1) {
   } else {
     return String();
   }
-  return v0->substr(v1);
+  return v0.Slice(v1);
 }
 
 }  // namespace dingodb::expr::calc
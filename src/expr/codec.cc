@@ -22,6 +22,8 @@
 
 #include "codec.h"
 
+#include <type_traits>
+
 namespace dingodb::expr {
 
 template <typename T>
@@ -98,4 +100,105 @@ const Byte *DecodeValue(DecimalP &value, const Byte *data) {
   return p + len;
 }
 
+// Throw if fewer than `size` bytes are left.
+static void CheckBytes(const Byte *data, const Byte *end, size_t size) {
+  if (static_cast<size_t>(end - data) < size) {
+    throw UnknownCode(data, end - data);
+  }
+}
+
+template <typename T>
+static const Byte *DecodeVarint(T &value, const Byte *data, const Byte *end) {
+  using U = std::make_unsigned_t<T>;
+  U u = 0;
+  int shift = 0;
+  for (const Byte *p = data; p < end && shift < static_cast<int>(sizeof(T) * 8); ++p, shift += 7) {
+    u |= (static_cast<U>(*p & 0x7F) << shift);
+    if ((*p & 0x80) == 0) {
+      value = static_cast<T>(u);
+      return p + 1;
+    }
+  }
+  // Truncated or too long.
+  throw UnknownCode(data, end - data);
+}
+
+template <>
+const Byte *DecodeValue(int &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(long &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(long long &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(unsigned int &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(unsigned long &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(unsigned long long &value, const Byte *data, const Byte *end) {
+  return DecodeVarint(value, data, end);
+}
+
+template <>
+const Byte *DecodeValue(float &value, const Byte *data, const Byte *end) {
+  CheckBytes(data, end, 4);
+  return DecodeValue(value, data);
+}
+
+template <>
+const Byte *DecodeValue(double &value, const Byte *data, const Byte *end) {
+  CheckBytes(data, end, 8);
+  return DecodeValue(value, data);
+}
+
+template <>
+const Byte *DecodeValue(String &value, const Byte *data, const Byte *end) {
+  uint32_t len;
+  const Byte *p = DecodeValue(len, data, end);
+  CheckBytes(p, end, len);
+  value = String(reinterpret_cast<const char *>(p), len);
+  return p + len;
+}
+
+template <>
+const Byte *DecodeValue(DecimalP &value, const Byte *data, const Byte *end) {
+  uint32_t len;
+  const Byte *p = DecodeValue(len, data, end);
+  CheckBytes(p, end, len);
+  value = DecimalP(std::string(reinterpret_cast<const char *>(p), len));
+  return p + len;
+}
+
+const Byte *DecodeDecimalBinary(DecimalP &value, const Byte *data, const Byte *end) {
+  uint32_t scale;
+  const Byte *p = DecodeValue(scale, data, end);
+  uint32_t len;
+  p = DecodeValue(len, p, end);
+  if (scale > ::dingodb::types::MAX_FIXED_SCALE || len == 0 || len > sizeof(::dingodb::types::int128_t)) {
+    throw UnknownCode(data, p - data);
+  }
+  CheckBytes(p, end, len);
+  // Sign extended by the first byte.
+  unsigned __int128 u = ((*p & 0x80) != 0 ? ~static_cast<unsigned __int128>(0) : 0);
+  for (uint32_t i = 0; i < len; ++i) {
+    u = (u << 8) | p[i];
+  }
+  value = DecimalP(static_cast<::dingodb::types::int128_t>(u), static_cast<int>(scale));
+  return p + len;
+}
+
 }  // namespace dingodb::expr
@@ -64,6 +64,60 @@ const Byte *DecodeValue(String &value, const Byte *data);
 template <>
 const Byte *DecodeValue(DecimalP &value, const Byte *data);
 
+/**
+ * @brief Decode a value from code buffer, without reading beyond the end.
+ *
+ * @tparam T type of the value
+ * @param value reference to the value
+ * @param data code buffer
+ * @param end the end of the code buffer
+ * @return const Byte* point to the next byte of the bytes used
+ * @throw UnknownCode if the value is truncated or malformed
+ */
+template <typename T>
+const Byte *DecodeValue(T &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(int &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(long &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(long long &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(unsigned int &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(unsigned long &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(unsigned long long &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(float &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(double &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(String &value, const Byte *data, const Byte *end);
+
+template <>
+const Byte *DecodeValue(DecimalP &value, const Byte *data, const Byte *end);
+
+/**
+ * @brief Decode a decimal in binary form, i.e. the scale as `INT32`, followed by the byte length as `INT32` and the
+ * bytes of the unscaled value in big-endian two's complement.
+ *
+ * @param value reference to the value
+ * @param data code buffer
+ * @param end the end of the code buffer
+ * @return const Byte* point to the next byte of the bytes used
+ */
+const Byte *DecodeDecimalBinary(DecimalP &value, const Byte *data, const Byte *end);
+
 template <typename T>
 const Byte *DecodeElements(T &container, size_t count, const Byte *code, size_t len) {
   const Byte *p = code;
@@ -0,0 +1,170 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _COLUMN_STACK_H_
+#define _COLUMN_STACK_H_
+
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "batch.h"
+
+namespace dingodb::expr {
+
+/**
+ * @brief The counterpart of `OperandStack` for batch evaluating, each element is a whole column.
+ */
+class ColumnStack {
+ public:
+  ColumnStack() : m_skip(0), m_batch(nullptr) {
+  }
+
+  virtual ~ColumnStack() = default;
+
+  void Pop() {
+    m_stack.pop_back();
+  }
+
+  const Column &Get() const {
+    return m_stack.back();
+  }
+
+  void Push(const Column &v) {
+    m_stack.push_back(v);
+  }
+
+  void BindBatch(const Batch *batch) {
+    m_batch = batch;
+  }
+
+  size_t BatchSize() const {
+    if (m_batch != nullptr) {
+      return m_batch->Size();
+    }
+    throw std::runtime_error("No batch provided.");
+  }
+
+  Column GetVar(int32_t index) const {
+    if (m_batch != nullptr) {
+      if (m_selections.empty()) {
+        return (*m_batch)[index];
+      }
+      return (*m_batch)[index].Masked(m_selections.back().get());
+    }
+    throw std::runtime_error("No batch provided.");
+  }
+
+  void PushVar(int32_t index) {
+    m_stack.push_back(GetVar(index));
+  }
+
+  void Clear() {
+    m_stack.clear();
+    m_selections.clear();
+    m_skip = 0;
+    m_error = nullptr;
+  }
+
+  /**
+   * @brief Report an error of the batch instead of throwing it, so that a batch costs no more than one error.
+   *
+   * Only the first error is kept, and the evaluating stops after the operator reporting it.
+   */
+  void SetError(std::exception_ptr error) {
+    if (m_error == nullptr) {
+      m_error = std::move(error);
+    }
+  }
+
+  bool HasError() const {
+    return m_error != nullptr;
+  }
+
+  std::exception_ptr GetError() const {
+    return m_error;
+  }
+
+  void Skip(size_t num) {
+    m_skip = num;
+  }
+
+  size_t TakeSkip() {
+    auto skip = m_skip;
+    m_skip = 0;
+    return skip;
+  }
+
+  /**
+   * @brief Get the bitmap of the rows selected to evaluate, `nullptr` if all rows are selected.
+   */
+  const uint64_t *GetSelection() const {
+    return m_selections.empty() ? nullptr : m_selections.back().get();
+  }
+
+  /**
+   * @brief Restrict the evaluating to the selected rows, until `PopSelection` is called.
+   *
+   * The variables pushed are masked by the selection, so the values of unselected rows are nulls and not computed.
+   */
+  void PushSelection(const std::shared_ptr<uint64_t[]> &selection) {
+    m_selections.push_back(selection);
+  }
+
+  void PopSelection() {
+    m_selections.pop_back();
+  }
+
+  void ReserveTemps(size_t num) {
+    if (m_temps.size() < num) {
+      m_temps.resize(num);
+    }
+  }
+
+  const Column &GetTemp(int32_t index) const {
+    return m_temps[index];
+  }
+
+  void SetTemp(int32_t index, const Column &v) {
+    m_temps[index] = v;
+  }
+
+  size_t Size() const {
+    return m_stack.size();
+  }
+
+  auto begin() const  // NOLINT(readability-identifier-naming)
+  {
+    return m_stack.cbegin();
+  }
+
+  auto end() const  // NOLINT(readability-identifier-naming)
+  {
+    return m_stack.cend();
+  }
+
+ private:
+  std::vector<Column> m_stack;
+  std::vector<std::shared_ptr<uint64_t[]>> m_selections;
+  size_t m_skip;
+  // Temporary slots for common sub-expressions.
+  std::vector<Column> m_temps;
+  const Batch *m_batch;
+  std::exception_ptr m_error;
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _COLUMN_STACK_H_ */
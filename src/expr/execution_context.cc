@@ -12,23 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "runner.h"
+#include "execution_context.h"
 
 #include <algorithm>
 
 namespace dingodb::expr {
 
-void Runner::Run() const {
-  m_operand_stack.Clear();
-  for (const auto *op : m_operator_vector) {
-    (*op)(m_operand_stack);
-  }
-}
-
-Tuple *Runner::GetAll() const {
+Tuple *ExecutionContext::GetAll() const {
   auto *tuple = new Tuple();
   std::copy(m_operand_stack.begin(), m_operand_stack.end(), std::back_inserter(*tuple));
   return tuple;
 }
 
+Batch *ExecutionContext::GetAllColumns() const {
+  auto *batch = new Batch(m_column_stack.BatchSize());
+  for (const auto &column : m_column_stack) {
+    batch->AddColumn(column);
+  }
+  return batch;
+}
+
 }  // namespace dingodb::expr
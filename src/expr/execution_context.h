@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_EXECUTION_CONTEXT_H_
+#define _EXPR_EXECUTION_CONTEXT_H_
+
+#include <optional>
+
+#include "batch.h"
+#include "column_stack.h"
+#include "operand_stack.h"
+#include "program.h"
+
+namespace dingodb::expr {
+
+/**
+ * @brief The states of evaluating a `Program`, i.e. the stacks, the temporary slots and the bound tuple.
+ *
+ * A context is cheap to create and must not be used by more than one thread at the same time.
+ */
+class ExecutionContext {
+ public:
+  ExecutionContext() = default;
+
+  /**
+   * @brief Create a context with the stack preallocated for the program.
+   */
+  ExecutionContext(const Program &program) {
+    Prepare(program);
+  }
+
+  virtual ~ExecutionContext() = default;
+
+  void Prepare(const Program &program) {
+    m_operand_stack.Reserve(program.GetMaxDepth());
+    m_operand_stack.ReserveTemps(program.GetTempNum());
+    m_column_stack.ReserveTemps(program.GetTempNum());
+  }
+
+  void BindTuple(const Tuple *tuple) {
+    m_operand_stack.BindTuple(tuple);
+  }
+
+  Operand Get() const {
+    return m_operand_stack.Get();
+  }
+
+  template <typename T>
+  std::optional<T> GetOptional() const {
+    auto operand = Get();
+    if (operand != nullptr) {
+      return std::optional<T>(operand.GetValue<T>());
+    }
+    return std::optional<T>();
+  }
+
+  /**
+   * @brief Get all the results as a tuple, which must be released by the caller.
+   */
+  Tuple *GetAll() const;
+
+  Column GetColumn() const {
+    return m_column_stack.Get();
+  }
+
+  /**
+   * @brief Get all the result columns as a batch, which must be released by the caller.
+   */
+  Batch *GetAllColumns() const;
+
+  OperandStack &GetOperandStack() {
+    return m_operand_stack;
+  }
+
+  ColumnStack &GetColumnStack() {
+    return m_column_stack;
+  }
+
+ private:
+  OperandStack m_operand_stack;
+  ColumnStack m_column_stack;
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_EXECUTION_CONTEXT_H_ */
@@ -17,7 +17,7 @@
 namespace dingodb::expr {
 
 std::ostream &operator<<(std::ostream &os, const String &v) {
-  os << *(v.m_ptr);
+  os << v.m_view;
   return os;
 }
 
@@ -15,88 +15,196 @@
 #ifndef _EXPR_EXPR_STRING_H_
 #define _EXPR_EXPR_STRING_H_
 
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 
 namespace dingodb::expr {
 
 /**
- * @brief Type to hold a string.
+ * @brief Type to hold a string, which is a view of characters and the owner of them.
  *
+ * Slices share the owner of the original string without copying. Strings of no more than `SMALL_SIZE` chars are kept
+ * inline instead, which are copied with the string but not allocated. The characters may also be owned by the caller,
+ * see `View`.
  */
 class String {
  public:
   using ValueType = std::shared_ptr<std::string>;
 
-  String(const std::shared_ptr<std::string> &ptr) : m_ptr(ptr) {
+  static constexpr size_t SMALL_SIZE = 16;
+
+  String(const std::shared_ptr<std::string> &ptr)
+      : m_ptr(ptr), m_view(ptr != nullptr ? std::string_view(*ptr) : std::string_view()) {
+  }
+
+  String(std::string &&str) {
+    if (str.size() <= SMALL_SIZE) {
+      InitSmall(str);
+    } else {
+      m_ptr = std::make_shared<std::string>(std::move(str));
+      m_view = *m_ptr;
+    }
+  }
+
+  String(const std::string &str) : String(str.data(), str.size()) {
+  }
+
+  String(const char *str) : String(str, std::char_traits<char>::length(str)) {
+  }
+
+  String(const char *str, size_t len) {
+    if (len <= SMALL_SIZE) {
+      InitSmall({str, len});
+    } else {
+      m_ptr = std::make_shared<std::string>(str, len);
+      m_view = *m_ptr;
+    }
+  }
+
+  String() = default;
+
+  String(const String &v) : m_ptr(v.m_ptr), m_view(v.m_view) {
+    CopySmall(v);
+  }
+
+  String(String &&v) noexcept : m_ptr(std::move(v.m_ptr)), m_view(v.m_view) {
+    CopySmall(v);
   }
 
-  String(const std::string &str) : m_ptr(std::make_shared<std::string>(str)) {
+  String &operator=(const String &v) {
+    if (this != &v) {
+      m_ptr = v.m_ptr;
+      m_view = v.m_view;
+      CopySmall(v);
+    }
+    return *this;
+  }
+
+  String &operator=(String &&v) noexcept {
+    if (this != &v) {
+      m_ptr = std::move(v.m_ptr);
+      m_view = v.m_view;
+      CopySmall(v);
+    }
+    return *this;
   }
 
-  String(const char *str) : m_ptr(std::make_shared<std::string>(str)) {
+  /**
+   * @brief Make a string pointing into a buffer owned by the caller, which must outlive the string and its slices.
+   */
+  static String View(std::string_view v) {
+    String str;
+    str.m_view = v;
+    return str;
   }
 
-  String(const char *str, size_t len) : m_ptr(std::make_shared<std::string>(str, len)) {
+  /**
+   * @brief Check if the characters are kept alive by the string itself, i.e. not owned by the caller, see `View`.
+   */
+  bool IsOwned() const {
+    return m_ptr != nullptr || m_view.empty() || IsSmall();
   }
 
-  String() : m_ptr(std::make_shared<std::string>()) {
+  /**
+   * @brief Get a string owning the characters, which are copied only if owned by the caller.
+   */
+  String Owned() const {
+    return IsOwned() ? *this : String(m_view.data(), m_view.size());
   }
 
+  /**
+   * @brief Get a slice sharing the characters, the arguments are the same as `std::string::substr`.
+   */
+  String Slice(size_t pos, size_t len = std::string_view::npos) const {
+    String str(*this);
+    str.m_view = str.m_view.substr(pos, len);
+    return str;
+  }
+
+  /**
+   * @brief Get the characters as a `std::string`, which is copied if this is a slice or not owned.
+   */
   ValueType GetPtr() const {
-    return m_ptr;
+    if (m_ptr != nullptr && m_ptr->data() == m_view.data() && m_ptr->size() == m_view.size()) {
+      return m_ptr;
+    }
+    return std::make_shared<std::string>(m_view);
   }
 
-  const std::string &operator*() const {
-    return *m_ptr;
+  std::string_view operator*() const {
+    return m_view;
   }
 
-  const std::string *operator->() const {
-    return &*m_ptr;
+  const std::string_view *operator->() const {
+    return &m_view;
   }
 
   String operator+(const String &v) const {
-    return *m_ptr + *v.m_ptr;
+    std::string str;
+    str.reserve(m_view.size() + v.m_view.size());
+    str.append(m_view).append(v.m_view);
+    return str;
   }
 
   bool operator==(const String &v) const {
-    return *m_ptr == *v.m_ptr;
+    return m_view == v.m_view;
   }
 
   bool operator!=(const String &v) const {
-    return *m_ptr != *v.m_ptr;
+    return m_view != v.m_view;
   }
 
   bool operator<(const String &v) const {
-    return *m_ptr < *v.m_ptr;
+    return m_view < v.m_view;
   }
 
   bool operator<=(const String &v) const {
-    return *m_ptr <= *v.m_ptr;
+    return m_view <= v.m_view;
   }
 
   bool operator>(const String &v) const {
-    return *m_ptr > *v.m_ptr;
+    return m_view > v.m_view;
   }
 
   bool operator>=(const String &v) const {
-    return *m_ptr >= *v.m_ptr;
+    return m_view >= v.m_view;
   }
 
   int find(const String &v) const {
-    std::size_t found = (*m_ptr).find(*v.GetPtr());
-    if (found != std::string::npos) {
+    std::size_t found = m_view.find(v.m_view);
+    if (found != std::string_view::npos) {
       return found + 1;
-    } else {
-      return 0;
     }
-
     return 0;
   }
 
  private:
+  void InitSmall(std::string_view v) {
+    std::char_traits<char>::copy(m_small, v.data(), v.size());
+    m_view = {m_small, v.size()};
+  }
+
+  bool IsSmall() const {
+    return m_ptr == nullptr && std::less_equal<const char *>()(m_small, m_view.data()) &&
+           std::less_equal<const char *>()(m_view.data(), m_small + SMALL_SIZE);
+  }
+
+  // Copy the inline characters of `v` and point to them, for `m_view` copied from `v`.
+  void CopySmall(const String &v) {
+    if (v.IsSmall()) {
+      auto pos = v.m_view.data() - v.m_small;
+      std::char_traits<char>::copy(m_small, v.m_small, pos + v.m_view.size());
+      m_view = {m_small + pos, v.m_view.size()};
+    }
+  }
+
+  // The owner of the characters, `nullptr` if they are inline, owned by the caller or empty.
   ValueType m_ptr;
+  std::string_view m_view;
+  char m_small[SMALL_SIZE];
 
   friend class Operand;
 
@@ -110,7 +218,7 @@ namespace std {
 template <>
 struct hash<::dingodb::expr::String> {
   size_t operator()(const ::dingodb::expr::String &val) const noexcept {
-    return hash<std::string>()(*val);
+    return hash<std::string_view>()(*val);
   }
 };
 
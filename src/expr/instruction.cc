@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "instruction.h"
+
+#include "exception.h"
+#include "operator.h"
+
+namespace dingodb::expr {
+
+void Slot::SetOperand(const Operand &v) {
+  if (v == nullptr) {
+    SetNull();
+  } else if (v.Is<int32_t>()) {
+    Set(v.GetValue<int32_t>());
+  } else if (v.Is<int64_t>()) {
+    Set(v.GetValue<int64_t>());
+  } else if (v.Is<bool>()) {
+    Set(v.GetValue<bool>());
+  } else if (v.Is<float>()) {
+    Set(v.GetValue<float>());
+  } else if (v.Is<double>()) {
+    Set(v.GetValue<double>());
+  } else if (v.Is<String>()) {
+    Set(v.GetValue<String>());
+  } else if (v.Is<DecimalP>()) {
+    Set(v.GetValue<DecimalP>());
+  } else {
+    throw ExprError("Unsupported operand type in register.");
+  }
+}
+
+Operand Slot::GetOperand() const {
+  switch (m_type) {
+  case TYPE_INT32:
+    return m_int32;
+  case TYPE_INT64:
+    return m_int64;
+  case TYPE_BOOL:
+    return m_bool;
+  case TYPE_FLOAT:
+    return m_float;
+  case TYPE_DOUBLE:
+    return m_double;
+  case TYPE_STRING:
+  case TYPE_DECIMAL:
+    return m_object;
+  default:
+    return nullptr;
+  }
+}
+
+const Instruction *Instruction::CallOperator(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+  OperandStack stack;
+  auto arity = inst.op->GetArity();
+  stack.Reserve(arity + 1);
+  stack.BindTuple(tuple);
+  for (int i = 0; i < arity; ++i) {
+    stack.Push(regs[inst.src[i]].GetOperand());
+  }
+  (*inst.op)(stack);
+  regs[inst.dst].SetOperand(stack.Get());
+  return &inst + 1;
+}
+
+}  // namespace dingodb::expr
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_INSTRUCTION_H_
+#define _EXPR_INSTRUCTION_H_
+
+#include <cstdint>
+#include <type_traits>
+
+#include "operand.h"
+#include "types.h"
+
+namespace dingodb::expr {
+
+class Operator;
+
+/**
+ * @brief A register of the VM. Scalars are stored unboxed, strings and decimals are kept in an `Operand`.
+ *
+ * The type tag is the type of the storage, so dates and timestamps are tagged as `TYPE_INT64`.
+ */
+class Slot {
+ public:
+  Slot() : m_type(TYPE_NULL), m_int64(0) {
+  }
+
+  Byte GetType() const {
+    return m_type;
+  }
+
+  bool IsNull() const {
+    return m_type == TYPE_NULL;
+  }
+
+  void SetNull() {
+    m_type = TYPE_NULL;
+  }
+
+  /**
+   * @brief Check if the slot holds a value stored as C++ type `T`.
+   */
+  template <typename T>
+  bool Holds() const {
+    return m_type == TagOf<T>();
+  }
+
+  template <typename T>
+  T Get() const {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      return m_int32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return m_int64;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return m_bool;
+    } else if constexpr (std::is_same_v<T, float>) {
+      return m_float;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return m_double;
+    } else {
+      return m_object.GetValue<T>();
+    }
+  }
+
+  template <typename T>
+  void Set(T v) {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      m_int32 = v;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      m_int64 = v;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      m_bool = v;
+    } else if constexpr (std::is_same_v<T, float>) {
+      m_float = v;
+    } else if constexpr (std::is_same_v<T, double>) {
+      m_double = v;
+    } else {
+      m_object = v;
+    }
+    m_type = TagOf<T>();
+  }
+
+  /**
+   * @brief Set from an `Operand` of any type, the type is detected at runtime.
+   */
+  void SetOperand(const Operand &v);
+
+  Operand GetOperand() const;
+
+ private:
+  template <typename T>
+  static constexpr Byte TagOf() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      return TYPE_INT32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return TYPE_INT64;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return TYPE_BOOL;
+    } else if constexpr (std::is_same_v<T, float>) {
+      return TYPE_FLOAT;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return TYPE_DOUBLE;
+    } else if constexpr (std::is_same_v<T, String>) {
+      return TYPE_STRING;
+    } else {
+      return TYPE_DECIMAL;
+    }
+  }
+
+  Byte m_type;
+  union {
+    int32_t m_int32;
+    int64_t m_int64;
+    bool m_bool;
+    float m_float;
+    double m_double;
+  };
+  Operand m_object;
+};
+
+/**
+ * @brief An instruction of the register VM, lowered from an `Operator`.
+ *
+ * The registers are numbered by the depth in the operand stack at which the operands would be, so an instruction reads
+ * its operands from `src` (the consecutive ones from `dst` for variadic operators) and writes the result to `dst`, which
+ * is always `src[0]` if there is any source, except for the jumps of variadic `AND` and `OR`. The execution function
+ * returns the next instruction to execute, which is the following one except for jumps.
+ */
+struct Instruction {
+  using Exec = const Instruction *(*)(const Instruction &inst, Slot *regs, const Tuple *tuple);
+
+  Exec exec = nullptr;
+  uint32_t dst = 0;
+  uint32_t src[3] = {0, 0, 0};
+  int32_t index = 0;
+  Slot imm;
+  const Operator *op = nullptr;
+
+  /**
+   * @brief Run `op` on an operand stack, for operators having no specialized instruction.
+   */
+  static const Instruction *CallOperator(const Instruction &inst, Slot *regs, const Tuple *tuple);
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_INSTRUCTION_H_ */
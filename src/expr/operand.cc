@@ -16,28 +16,98 @@
 
 namespace dingodb::expr {
 
+bool Operand::Equals(const Operand &v) const {
+  if (Is<String>() && v.Is<String>()) {
+    return GetStringView() == v.GetStringView();
+  }
+  if (m_tag != v.m_tag) {
+    return false;
+  }
+  switch (m_tag) {
+  case TAG_DECIMAL:
+    return GetBox<DecimalP>(TAG_DECIMAL) == v.GetBox<DecimalP>(TAG_DECIMAL);
+  case TAG_INT32_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<int32_t>>>(m_tag) ==
+           v.GetBox<std::shared_ptr<std::vector<int32_t>>>(m_tag);
+  case TAG_INT64_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<int64_t>>>(m_tag) ==
+           v.GetBox<std::shared_ptr<std::vector<int64_t>>>(m_tag);
+  case TAG_BOOL_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<bool>>>(m_tag) == v.GetBox<std::shared_ptr<std::vector<bool>>>(m_tag);
+  case TAG_FLOAT_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<float>>>(m_tag) == v.GetBox<std::shared_ptr<std::vector<float>>>(m_tag);
+  case TAG_DOUBLE_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<double>>>(m_tag) ==
+           v.GetBox<std::shared_ptr<std::vector<double>>>(m_tag);
+  case TAG_STRING_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<std::string>>>(m_tag) ==
+           v.GetBox<std::shared_ptr<std::vector<std::string>>>(m_tag);
+  case TAG_DECIMAL_ARRAY:
+    return GetBox<std::shared_ptr<std::vector<DecimalP>>>(m_tag) ==
+           v.GetBox<std::shared_ptr<std::vector<DecimalP>>>(m_tag);
+  default:
+    return EqualScalars(v);
+  }
+}
+
+size_t Operand::Hash() const {
+  switch (m_tag) {
+  case TAG_NULL:
+    return 0;
+  case TAG_INT32:
+    return std::hash<int32_t>()(GetScalar<int32_t>());
+  case TAG_INT64:
+    return std::hash<int64_t>()(GetScalar<int64_t>());
+  case TAG_BOOL:
+    return std::hash<bool>()(GetScalar<bool>());
+  case TAG_FLOAT:
+    return std::hash<float>()(GetScalar<float>());
+  case TAG_DOUBLE:
+    return std::hash<double>()(GetScalar<double>());
+  case TAG_SMALL_STRING:
+  case TAG_STRING:
+    return std::hash<std::string_view>()(GetStringView());
+  case TAG_DECIMAL:
+    return std::hash<DecimalP>()(GetBox<DecimalP>(TAG_DECIMAL));
+  default:
+    // Arrays are compared by identity.
+    return std::hash<const void *>()(GetBoxBase());
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const Operand &v) {
-  if (std::holds_alternative<int32_t>(v.m_data)) {
-    os << std::get<int32_t>(v.m_data);
-  } else if (std::holds_alternative<int64_t>(v.m_data)) {
-    os << std::get<int64_t>(v.m_data);
-  } else if (std::holds_alternative<bool>(v.m_data)) {
-    os << std::get<bool>(v.m_data);
-  } else if (std::holds_alternative<float>(v.m_data)) {
-    os << std::get<float>(v.m_data);
-  } else if (std::holds_alternative<double>(v.m_data)) {
-    os << std::get<double>(v.m_data);
-  } else if (std::holds_alternative<String>(v.m_data)) {
-    os << std::get<String>(v.m_data);
-  } else if (std::holds_alternative<DecimalP>(v.m_data)) {
-      os << std::get<DecimalP>(v.m_data);
-  } else if (std::holds_alternative<std::monostate>(v.m_data)) {
+  switch (v.m_tag) {
+  case Operand::TAG_NULL:
     os << "(null)";
-  } else {
+    break;
+  case Operand::TAG_INT32:
+    os << v.GetScalar<int32_t>();
+    break;
+  case Operand::TAG_INT64:
+    os << v.GetScalar<int64_t>();
+    break;
+  case Operand::TAG_BOOL:
+    os << v.GetScalar<bool>();
+    break;
+  case Operand::TAG_FLOAT:
+    os << v.GetScalar<float>();
+    break;
+  case Operand::TAG_DOUBLE:
+    os << v.GetScalar<double>();
+    break;
+  case Operand::TAG_SMALL_STRING:
+  case Operand::TAG_STRING:
+    os << v.GetStringView();
+    break;
+  case Operand::TAG_DECIMAL:
+    os << v.GetBox<DecimalP>(Operand::TAG_DECIMAL);
+    break;
+  default:
     os << "<Unknown type>";
   }
   return os;
 }
+
 namespace any_optional_data_adaptor {
 
 template <>
@@ -16,7 +16,10 @@
 #define _EXPR_OPERAND_H_
 
 #include <any>
+#include <atomic>
+#include <cstring>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -28,91 +31,393 @@ using namespace dingodb::types;
 
 namespace dingodb::expr {
 
+/**
+ * @brief A value of any type, or null, in 16 bytes.
+ *
+ * Scalars are stored inline, so are strings of no more than `SMALL_STRING_SIZE` bytes if constructed from characters.
+ * Other strings, decimals and arrays are kept in a reference-counted box, which is shared by copies.
+ */
 class Operand {
  public:
+  static constexpr size_t SMALL_STRING_SIZE = 14;
+
   template <typename T>
-  Operand(T v) : m_data(v) {
+  Operand(T v) {
+    Init(std::move(v));
+  }
+
+  Operand(const char *v) {
+    InitString(v);
+  }
+
+  Operand(String::ValueType v) {
+    InitBox(TAG_STRING, String(v));
+  }
+
+  Operand(DecimalP v) {
+    InitBox(TAG_DECIMAL, std::move(v));
+  }
+
+  Operand(std::shared_ptr<DecimalP> v) {
+    InitBox(TAG_DECIMAL, *v);
+  }
+
+  Operand(DecimalP::ValueType v) {
+    InitBox(TAG_DECIMAL, DecimalP(v));
   }
 
-  Operand(String::ValueType v) : m_data(String(v)) {
+  // The bytes are zeroed for a null operand, not to copy uninitialized ones.
+  Operand([[maybe_unused]] std::nullptr_t v) : m_bytes{}, m_tag(TAG_NULL) {
   }
 
-  Operand(DecimalP v) : m_data(v) {
+  Operand() : m_bytes{}, m_tag(TAG_NULL) {
   }
 
-  Operand(std::shared_ptr<DecimalP> v) : m_data(*v) {
+  Operand(const Operand &v) {
+    CopyBits(v);
+    Retain();
   }
 
-  Operand(DecimalP::ValueType v) : m_data(DecimalP(v)) {
+  Operand(Operand &&v) noexcept {
+    CopyBits(v);
+    v.m_tag = TAG_NULL;
   }
 
-  Operand([[maybe_unused]] std::nullptr_t v) {
+  ~Operand() {
+    Release();
   }
 
-  Operand() = default;
+  Operand &operator=(const Operand &v) {
+    if (this != &v) {
+      v.Retain();
+      Release();
+      CopyBits(v);
+    }
+    return *this;
+  }
+
+  Operand &operator=(Operand &&v) noexcept {
+    if (this != &v) {
+      Release();
+      CopyBits(v);
+      v.m_tag = TAG_NULL;
+    }
+    return *this;
+  }
 
   bool operator==(const Operand &v) const {
-    return m_data == v.m_data;
+    if (m_tag == v.m_tag && m_tag < TAG_SMALL_STRING) {
+      return EqualScalars(v);
+    }
+    return Equals(v);
   }
 
   bool operator==([[maybe_unused]] std::nullptr_t v) const {
-    return std::holds_alternative<std::monostate>(m_data);
+    return m_tag == TAG_NULL;
   }
 
   bool operator!=(const Operand &v) const {
-    return m_data != v.m_data;
+    return !(*this == v);
   }
 
   bool operator!=([[maybe_unused]] std::nullptr_t v) const {
-    return !std::holds_alternative<std::monostate>(m_data);
+    return m_tag != TAG_NULL;
   }
 
+  /**
+   * @brief Get the value as C++ type `T`, throw `std::bad_variant_access` if the type is not matched.
+   *
+   * Getting a `String` of an inline string copies the characters into the `String`, which keeps them inline as well.
+   */
   template <typename T>
   inline T GetValue() const {
-      return std::get<T>(m_data);
+    if constexpr (std::is_same_v<T, String>) {
+      if (m_tag == TAG_SMALL_STRING) {
+        return String(m_bytes, SmallStringSize());
+      }
+      return GetBox<String>(TAG_STRING);
+    } else if constexpr (IsScalar<T>()) {
+      if (m_tag != TagOf<T>()) {
+        throw std::bad_variant_access();
+      }
+      return GetScalar<T>();
+    } else {
+      return GetBox<T>(TagOf<T>());
+    }
+  }
+
+  /**
+   * @brief Get the value as C++ type `T` without checking the type, which must be known to match, e.g. by verifying.
+   */
+  template <typename T>
+  inline T GetValueUnchecked() const {
+    if constexpr (std::is_same_v<T, String>) {
+      if (m_tag == TAG_SMALL_STRING) {
+        return String(m_bytes, SmallStringSize());
+      }
+      return static_cast<const Box<String> *>(GetBoxBase())->value;
+    } else if constexpr (IsScalar<T>()) {
+      return GetScalar<T>();
+    } else {
+      return static_cast<const Box<T> *>(GetBoxBase())->value;
+    }
+  }
+
+  /**
+   * @brief Get the characters of a string without copying, which are valid as long as the operand is.
+   */
+  std::string_view GetStringView() const {
+    if (m_tag == TAG_SMALL_STRING) {
+      return {m_bytes, SmallStringSize()};
+    }
+    return *GetBox<String>(TAG_STRING);
+  }
+
+  /**
+   * @brief Get the operand with the characters of a string copied if they are owned by the caller, to keep it longer
+   * than the buffer, see `String::View`.
+   */
+  Operand Owned() const {
+    if (m_tag == TAG_STRING) {
+      const auto &v = GetBox<String>(TAG_STRING);
+      if (!v.IsOwned()) {
+        return v.Owned();
+      }
+    }
+    return *this;
   }
 
   inline bool isInt() const {
-    return std::holds_alternative<int32_t>(m_data);
+    return m_tag == TAG_INT32;
   }
 
   inline bool isLong() const {
-    return std::holds_alternative<int64_t>(m_data);
+    return m_tag == TAG_INT64;
   }
 
   inline bool isBool() const {
-    return std::holds_alternative<bool>(m_data);
+    return m_tag == TAG_BOOL;
+  }
+
+  template <typename T>
+  inline bool Is() const {
+    if constexpr (std::is_same_v<T, String>) {
+      return m_tag == TAG_SMALL_STRING || m_tag == TAG_STRING;
+    } else {
+      return m_tag == TagOf<T>();
+    }
   }
 
   template <typename T>
   T GetInteriorValue() const {
-    return std::get<T>(m_data);
+    return GetValue<T>();
   }
 
  private:
-  std::variant<
-      std::monostate,
-      int32_t,
-      int64_t,
-      bool,
-      float,
-      double,
-      String,
-      DecimalP,
-      std::shared_ptr<std::vector<int32_t>>,
-      std::shared_ptr<std::vector<int64_t>>,
-      std::shared_ptr<std::vector<bool>>,
-      std::shared_ptr<std::vector<float>>,
-      std::shared_ptr<std::vector<double>>,
-      std::shared_ptr<std::vector<std::string>>,
-      std::shared_ptr<std::vector<DecimalP>>>
-      m_data;
+  enum Tag : Byte {
+    TAG_NULL,
+    TAG_INT32,
+    TAG_INT64,
+    TAG_BOOL,
+    TAG_FLOAT,
+    TAG_DOUBLE,
+    TAG_SMALL_STRING,
+    // The following ones are boxed.
+    TAG_STRING,
+    TAG_DECIMAL,
+    TAG_INT32_ARRAY,
+    TAG_INT64_ARRAY,
+    TAG_BOOL_ARRAY,
+    TAG_FLOAT_ARRAY,
+    TAG_DOUBLE_ARRAY,
+    TAG_STRING_ARRAY,
+    TAG_DECIMAL_ARRAY,
+  };
+
+  struct BoxBase {
+    virtual ~BoxBase() = default;
+
+    std::atomic<uint32_t> refs{1};
+  };
+
+  template <typename T>
+  struct Box : public BoxBase {
+    explicit Box(T v) : value(std::move(v)) {
+    }
+
+    T value;
+  };
+
+  template <typename T>
+  static constexpr bool IsScalar() {
+    return std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, bool> ||
+           std::is_same_v<T, float> || std::is_same_v<T, double>;
+  }
+
+  template <typename T>
+  static constexpr Tag TagOf() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      return TAG_INT32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return TAG_INT64;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return TAG_BOOL;
+    } else if constexpr (std::is_same_v<T, float>) {
+      return TAG_FLOAT;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return TAG_DOUBLE;
+    } else if constexpr (std::is_same_v<T, String>) {
+      return TAG_STRING;
+    } else if constexpr (std::is_same_v<T, DecimalP>) {
+      return TAG_DECIMAL;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<int32_t>>>) {
+      return TAG_INT32_ARRAY;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<int64_t>>>) {
+      return TAG_INT64_ARRAY;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<bool>>>) {
+      return TAG_BOOL_ARRAY;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<float>>>) {
+      return TAG_FLOAT_ARRAY;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<double>>>) {
+      return TAG_DOUBLE_ARRAY;
+    } else if constexpr (std::is_same_v<T, std::shared_ptr<std::vector<std::string>>>) {
+      return TAG_STRING_ARRAY;
+    } else {
+      static_assert(std::is_same_v<T, std::shared_ptr<std::vector<DecimalP>>>, "Unsupported operand type.");
+      return TAG_DECIMAL_ARRAY;
+    }
+  }
+
+  template <typename T>
+  void Init(T v) {
+    if constexpr (std::is_same_v<T, bool>) {
+      InitScalar(TAG_BOOL, v);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= sizeof(int32_t)) {
+      InitScalar(TAG_INT32, static_cast<int32_t>(v));
+    } else if constexpr (std::is_integral_v<T>) {
+      InitScalar(TAG_INT64, static_cast<int64_t>(v));
+    } else if constexpr (std::is_same_v<T, float>) {
+      InitScalar(TAG_FLOAT, v);
+    } else if constexpr (std::is_same_v<T, double>) {
+      InitScalar(TAG_DOUBLE, v);
+    } else if constexpr (std::is_same_v<T, String>) {
+      // Not shared with any owner, so kept inline if short enough.
+      if (v.m_ptr == nullptr && v->size() <= SMALL_STRING_SIZE) {
+        InitString(*v);
+      } else {
+        InitBox(TAG_STRING, std::move(v));
+      }
+    } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+      InitString(v);
+    } else if constexpr (std::is_same_v<T, Decimal>) {
+      InitBox(TAG_DECIMAL, DecimalP(v));
+    } else {
+      InitBox(TagOf<T>(), std::move(v));
+    }
+  }
+
+  template <typename T>
+  void InitScalar(Tag tag, T v) {
+    std::memcpy(m_bytes, &v, sizeof(T));
+    m_tag = tag;
+  }
+
+  template <typename T>
+  void InitBox(Tag tag, T v) {
+    BoxBase *box = new Box<T>(std::move(v));
+    std::memcpy(m_bytes, &box, sizeof(BoxBase *));
+    m_tag = tag;
+  }
+
+  void InitString(std::string_view v) {
+    if (v.size() <= SMALL_STRING_SIZE) {
+      std::memcpy(m_bytes, v.data(), v.size());
+      m_bytes[SMALL_STRING_SIZE] = static_cast<char>(v.size());
+      m_tag = TAG_SMALL_STRING;
+    } else {
+      InitBox(TAG_STRING, String(v.data(), v.size()));
+    }
+  }
+
+  void CopyBits(const Operand &v) {
+    std::memcpy(m_bytes, v.m_bytes, sizeof(m_bytes));
+    m_tag = v.m_tag;
+  }
+
+  template <typename T>
+  T GetScalar() const {
+    T v;
+    std::memcpy(&v, m_bytes, sizeof(T));
+    return v;
+  }
+
+  BoxBase *GetBoxBase() const {
+    return GetScalar<BoxBase *>();
+  }
+
+  template <typename T>
+  const T &GetBox(Tag tag) const {
+    if (m_tag != tag) {
+      throw std::bad_variant_access();
+    }
+    return static_cast<const Box<T> *>(GetBoxBase())->value;
+  }
+
+  size_t SmallStringSize() const {
+    return static_cast<unsigned char>(m_bytes[SMALL_STRING_SIZE]);
+  }
+
+  bool IsBoxed() const {
+    return m_tag > TAG_SMALL_STRING;
+  }
+
+  void Retain() const {
+    if (IsBoxed()) {
+      GetBoxBase()->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void Release() {
+    if (IsBoxed()) {
+      auto *box = GetBoxBase();
+      if (box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete box;
+      }
+    }
+  }
+
+  bool EqualScalars(const Operand &v) const {
+    switch (m_tag) {
+    case TAG_INT32:
+      return GetScalar<int32_t>() == v.GetScalar<int32_t>();
+    case TAG_INT64:
+      return GetScalar<int64_t>() == v.GetScalar<int64_t>();
+    case TAG_BOOL:
+      return GetScalar<bool>() == v.GetScalar<bool>();
+    case TAG_FLOAT:
+      return GetScalar<float>() == v.GetScalar<float>();
+    case TAG_DOUBLE:
+      return GetScalar<double>() == v.GetScalar<double>();
+    default:
+      return true;
+    }
+  }
+
+  bool Equals(const Operand &v) const;
+
+  size_t Hash() const;
+
+  alignas(8) char m_bytes[SMALL_STRING_SIZE + 1];
+  Tag m_tag;
 
   friend class std::hash<::dingodb::expr::Operand>;
 
   friend std::ostream &operator<<(std::ostream &os, const Operand &v);
 };
 
+static_assert(sizeof(Operand) == 16);
+static_assert(Operand::SMALL_STRING_SIZE <= String::SMALL_SIZE, "Inline strings must be got without allocation.");
+
 using Tuple = std::vector<Operand>;
 
 namespace any_optional_data_adaptor {
@@ -170,7 +475,7 @@ namespace std {
 template <>
 struct hash<::dingodb::expr::Operand> {
   size_t operator()(const ::dingodb::expr::Operand &val) const noexcept {
-    return hash<decltype(val.m_data)>()(val.m_data);
+    return val.Hash();
   }
 };
 
@@ -15,60 +15,120 @@
 #ifndef _OPERAND_STACK_H_
 #define _OPERAND_STACK_H_
 
-#include <deque>
-#include <stdexcept>
+#include <vector>
 
 #include "operand.h"
 
 namespace dingodb::expr {
 
+/**
+ * @brief The operand stack, which is a contiguous array to avoid allocating while running.
+ *
+ * Popped elements are not destructed but overwritten by the following pushes. Nothing is checked while running, so the
+ * stack must be reserved to the maximum depth and the tuple bound checked against the program, by `Program::Run`.
+ */
 class OperandStack {
  public:
-  OperandStack() : m_tuple(nullptr) {
+  OperandStack() : m_size(0), m_skip(0), m_tuple(nullptr) {
   }
 
   virtual ~OperandStack() = default;
 
+  /**
+   * @brief Preallocate the stack, typically to the maximum depth got by decoding.
+   */
+  void Reserve(size_t depth) {
+    if (m_stack.size() < depth) {
+      m_stack.resize(depth);
+    }
+  }
+
+  void ReserveTemps(size_t num) {
+    if (m_temps.size() < num) {
+      m_temps.resize(num);
+    }
+  }
+
   void Pop() {
-    m_stack.pop_back();
+    --m_size;
+  }
+
+  void Pop(size_t num) {
+    m_size -= num;
   }
 
   Operand Get() const {
-    return m_stack.back();
+    return m_stack[m_size - 1];
+  }
+
+  /**
+   * @brief Get the operand `n` elements below the top, which is `Get()` for 0, for operators of many operands.
+   */
+  const Operand &Peek(size_t n) const {
+    return m_stack[m_size - 1 - n];
   }
 
   void Push(const Operand &v) {
-    m_stack.push_back(v);
+    m_stack[m_size++] = v;
   }
 
   template <typename T>
   void Push(T v) {
-    m_stack.push_back(v);
+    Push(Operand(v));
   }
 
   template <typename T>
   void Push() {
-    m_stack.push_back(nullptr);
+    Push(Operand(nullptr));
   }
 
   void BindTuple(const Tuple *tuple) {
     m_tuple = tuple;
   }
 
+  const Tuple *GetTuple() const {
+    return m_tuple;
+  }
+
+  const Operand &GetVar(int32_t index) const {
+    return (*m_tuple)[index];
+  }
+
   void PushVar(int32_t index) {
-    if (m_tuple != nullptr) {
-      m_stack.push_back((*m_tuple)[index]);
-    } else {
-      throw std::runtime_error("No tuple provided.");
-    }
+    Push(GetVar(index));
   }
 
   void Clear() {
-    m_stack.clear();
+    m_size = 0;
+    m_skip = 0;
+  }
+
+  /**
+   * @brief Require the runner to skip the following operators, called by jump operators.
+   */
+  void Skip(size_t num) {
+    m_skip = num;
+  }
+
+  /**
+   * @brief Get the number of operators to skip and reset it.
+   */
+  size_t TakeSkip() {
+    auto skip = m_skip;
+    m_skip = 0;
+    return skip;
+  }
+
+  const Operand &GetTemp(int32_t index) const {
+    return m_temps[index];
+  }
+
+  void SetTemp(int32_t index, const Operand &v) {
+    m_temps[index] = v;
   }
 
   size_t Size() const {
-    return m_stack.size();
+    return m_size;
   }
 
   auto begin() const  // NOLINT(readability-identifier-naming)
@@ -78,11 +138,15 @@ class OperandStack {
 
   auto end() const  // NOLINT(readability-identifier-naming)
   {
-    return m_stack.cend();
+    return m_stack.cbegin() + m_size;
   }
 
  private:
-  std::deque<Operand> m_stack;
+  std::vector<Operand> m_stack;
+  size_t m_size;
+  size_t m_skip;
+  // Temporary slots for common sub-expressions.
+  std::vector<Operand> m_temps;
   const Tuple *m_tuple;
 };
 
@@ -22,22 +22,46 @@ void NotOperator::operator()(OperandStack &stack) const {
   auto v = stack.Get();
   stack.Pop();
   if (v != nullptr) {
-    stack.Push(!v.GetValue<bool>());
+    stack.Push(!v.GetValueUnchecked<bool>());
   } else {
     stack.Push<bool>();
   }
 }
 
+void NotOperator::operator()(ColumnStack &stack) const {
+  auto v = stack.Get();
+  stack.Pop();
+  auto size = stack.BatchSize();
+  auto r = Column::Make<bool>(TYPE_BOOL, size);
+  r.CopyValidity(v);
+  const auto *in = v.Values<bool>();
+  auto *out = r.Values<bool>();
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = !in[i];
+  }
+  stack.Push(r);
+}
+
+const Instruction *NotOperator::Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+  auto &v = regs[inst.src[0]];
+  if (!v.IsNull()) {
+    regs[inst.dst].Set(!v.Get<bool>());
+  } else {
+    regs[inst.dst].SetNull();
+  }
+  return &inst + 1;
+}
+
 void AndOperator::operator()(OperandStack &stack) const {
   auto v1 = stack.Get();
   stack.Pop();
   auto v0 = stack.Get();
   stack.Pop();
   if (v0 != nullptr) {
-    if (!v0.GetValue<bool>()) {
+    if (!v0.GetValueUnchecked<bool>()) {
       stack.Push(false);
     } else if (v1 != nullptr) {
-      stack.Push(v1.GetValue<bool>());
+      stack.Push(v1.GetValueUnchecked<bool>());
     } else {
       stack.Push<bool>();
     }
@@ -48,16 +72,50 @@ void AndOperator::operator()(OperandStack &stack) const {
   }
 }
 
+void AndOperator::operator()(ColumnStack &stack) const {
+  auto v1 = stack.Get();
+  stack.Pop();
+  auto v0 = stack.Get();
+  stack.Pop();
+  auto size = stack.BatchSize();
+  auto r = Column::Make<bool>(TYPE_BOOL, size);
+  const auto *in0 = v0.Values<bool>();
+  const auto *in1 = v1.Values<bool>();
+  for (size_t i = 0; i < size; ++i) {
+    bool null0 = v0.IsNull(i);
+    bool null1 = v1.IsNull(i);
+    if ((!null0 && !in0[i]) || (!null1 && !in1[i])) {
+      r.Set(i, false);
+    } else if (!null0 && !null1) {
+      r.Set(i, true);
+    }
+  }
+  stack.Push(r);
+}
+
+const Instruction *AndOperator::Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+  const auto &v0 = regs[inst.src[0]];
+  const auto &v1 = regs[inst.src[1]];
+  if ((!v0.IsNull() && !v0.Get<bool>()) || (!v1.IsNull() && !v1.Get<bool>())) {
+    regs[inst.dst].Set(false);
+  } else if (!v0.IsNull() && !v1.IsNull()) {
+    regs[inst.dst].Set(true);
+  } else {
+    regs[inst.dst].SetNull();
+  }
+  return &inst + 1;
+}
+
 void OrOperator::operator()(OperandStack &stack) const {
   auto v1 = stack.Get();
   stack.Pop();
   auto v0 = stack.Get();
   stack.Pop();
   if (v0 != nullptr) {
-    if (v0.GetValue<bool>()) {
+    if (v0.GetValueUnchecked<bool>()) {
       stack.Push(true);
     } else if (v1 != nullptr) {
-      stack.Push(v1.GetValue<bool>());
+      stack.Push(v1.GetValueUnchecked<bool>());
     } else {
       stack.Push<bool>();
     }
@@ -68,4 +126,38 @@ void OrOperator::operator()(OperandStack &stack) const {
   }
 }
 
+void OrOperator::operator()(ColumnStack &stack) const {
+  auto v1 = stack.Get();
+  stack.Pop();
+  auto v0 = stack.Get();
+  stack.Pop();
+  auto size = stack.BatchSize();
+  auto r = Column::Make<bool>(TYPE_BOOL, size);
+  const auto *in0 = v0.Values<bool>();
+  const auto *in1 = v1.Values<bool>();
+  for (size_t i = 0; i < size; ++i) {
+    bool null0 = v0.IsNull(i);
+    bool null1 = v1.IsNull(i);
+    if ((!null0 && in0[i]) || (!null1 && in1[i])) {
+      r.Set(i, true);
+    } else if (!null0 && !null1) {
+      r.Set(i, false);
+    }
+  }
+  stack.Push(r);
+}
+
+const Instruction *OrOperator::Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+  const auto &v0 = regs[inst.src[0]];
+  const auto &v1 = regs[inst.src[1]];
+  if ((!v0.IsNull() && v0.Get<bool>()) || (!v1.IsNull() && v1.Get<bool>())) {
+    regs[inst.dst].Set(true);
+  } else if (!v0.IsNull() && !v1.IsNull()) {
+    regs[inst.dst].Set(false);
+  } else {
+    regs[inst.dst].SetNull();
+  }
+  return &inst + 1;
+}
+
 }  // namespace dingodb::expr
@@ -18,7 +18,12 @@
 #include <functional>
 
 #include "calc/casting.h"
+#include "calc/kernels.h"
+#include "column_stack.h"
+#include "exception.h"
+#include "instruction.h"
 #include "operand_stack.h"
+#include "operator_arena.h"
 
 namespace dingodb::expr {
 
@@ -28,7 +33,75 @@ class Operator {
 
   virtual void operator()(OperandStack &stack) const = 0;
 
+  /**
+   * @brief Evaluate over a whole batch, the columns are pushed/popped just as operands in `OperandStack`.
+   */
+  virtual void operator()(ColumnStack &stack) const = 0;
+
   virtual Byte GetType() const = 0;
+
+  /**
+   * @brief Get the number of operands popped from the stack, one result is always pushed.
+   */
+  virtual int GetArity() const = 0;
+
+  /**
+   * @brief Get the type of the `i`th operand, `TYPE_NULL` if any type is accepted, i.e. the value is not got.
+   *
+   * The types are checked by verifying after decoding, so the operators get the values without checking at running time.
+   */
+  virtual Byte GetOperandType([[maybe_unused]] int i) const {
+    return TYPE_NULL;
+  }
+
+  /**
+   * @brief Get the index of the variable read from the tuple, whose type is the type of the operator, -1 if none.
+   */
+  virtual int32_t GetVarIndex() const {
+    return -1;
+  }
+
+  /**
+   * @brief Check if the operator always pushes the same value without popping anything.
+   */
+  virtual bool IsConst() const {
+    return false;
+  }
+
+  /**
+   * @brief Check if the operator does exactly the same as another one, which is the same object by default.
+   */
+  virtual bool IsSame(const Operator *op) const {
+    return this == op;
+  }
+
+  /**
+   * @brief Get the hash code, which must be equal for operators that are the same.
+   */
+  virtual size_t Hash() const {
+    return std::hash<const Operator *>()(this);
+  }
+
+  /**
+   * @brief Fuse with the operands, a variable followed by a constant, into one operator reading the tuple directly.
+   *
+   * @param arena where the fused operator is allocated
+   * @return const Operator* the fused operator, or `nullptr` if not supported
+   */
+  virtual const Operator *FuseVarConst(
+      [[maybe_unused]] const Operator *var,
+      [[maybe_unused]] const Operator *c,
+      [[maybe_unused]] OperatorArena &arena
+  ) const {
+    return nullptr;
+  }
+
+  /**
+   * @brief Fill the execution function of an instruction of the register VM, the registers are set by the caller.
+   */
+  virtual void Lower(Instruction &inst) const {
+    inst.exec = Instruction::CallOperator;
+  }
 };
 
 template <Byte R>
@@ -45,6 +118,28 @@ class NullOperator : public OperatorBase<R> {
   void operator()(OperandStack &stack) const override {
     stack.Push<TypeOf<R>>();
   }
+
+  void operator()(ColumnStack &stack) const override {
+    stack.Push(Column::Make<TypeOf<R>>(R, stack.BatchSize()));
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  bool IsConst() const override {
+    return true;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst].SetNull();
+    return &inst + 1;
+  }
 };
 
 template <Byte R>
@@ -57,7 +152,42 @@ class ConstOperator : public OperatorBase<R> {
     stack.Push(m_value);
   }
 
+  void operator()(ColumnStack &stack) const override {
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    std::fill_n(r.template Values<TypeOf<R>>(), size, m_value);
+    r.SetAllValid();
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  bool IsConst() const override {
+    return true;
+  }
+
+  bool IsSame(const Operator *op) const override {
+    const auto *c = dynamic_cast<const ConstOperator<R> *>(op);
+    return c != nullptr && c->m_value == m_value;
+  }
+
+  size_t Hash() const override {
+    return std::hash<TypeOf<R>>()(m_value) * 31 + R;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.imm.Set(m_value);
+    inst.exec = Exec;
+  }
+
  private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst] = inst.imm;
+    return &inst + 1;
+  }
+
   TypeOf<R> m_value;
 };
 
@@ -69,6 +199,32 @@ class ConstBoolOperator : public OperatorBase<TYPE_BOOL> {
   void operator()(OperandStack &stack) const override {
     stack.Push(V);
   }
+
+  void operator()(ColumnStack &stack) const override {
+    auto size = stack.BatchSize();
+    auto r = Column::Make<bool>(TYPE_BOOL, size);
+    std::fill_n(r.Values<bool>(), size, V);
+    r.SetAllValid();
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  bool IsConst() const override {
+    return true;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst].Set(V);
+    return &inst + 1;
+  }
 };
 
 template <Byte R>
@@ -81,10 +237,153 @@ class IndexedVarOperator : public OperatorBase<R> {
     stack.PushVar(m_index);
   }
 
+  void operator()(ColumnStack &stack) const override {
+    stack.PushVar(m_index);
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  int32_t GetIndex() const {
+    return m_index;
+  }
+
+  int32_t GetVarIndex() const override {
+    return m_index;
+  }
+
+  bool IsSame(const Operator *op) const override {
+    const auto *v = dynamic_cast<const IndexedVarOperator<R> *>(op);
+    return v != nullptr && v->m_index == m_index;
+  }
+
+  size_t Hash() const override {
+    return std::hash<int32_t>()(m_index) * 31 + R;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.index = m_index;
+    inst.exec = Exec;
+  }
+
  private:
+  // The variables may be passed through without being of the type, e.g. projected.
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+    const auto &v = (*tuple)[inst.index];
+    if (v.Is<TypeOf<R>>()) {
+      regs[inst.dst].Set(v.GetValueUnchecked<TypeOf<R>>());
+    } else {
+      regs[inst.dst].SetOperand(v);
+    }
+    return &inst + 1;
+  }
+
   int32_t m_index;
 };
 
+/**
+ * @brief Recompute the non-null rows of a column after a kernel reported an overflow, which may be of a null row.
+ *
+ * The overflow of a non-null row is reported as the error of the batch, to be thrown once by `RunBatch`.
+ *
+ * @tparam B the type overflowed
+ * @param calc computes the row and returns false on overflow
+ */
+template <Byte B = TYPE_INT64, typename F>
+void CheckOverflow(ColumnStack &stack, const Column &r, F calc) {
+  bool ok = true;
+  for (size_t i = 0; i < r.Size(); ++i) {
+    if (!r.IsNull(i)) {
+      ok &= calc(i);
+    }
+  }
+  if (!ok) {
+    stack.SetError(std::make_exception_ptr(ExceedsLimits<B>()));
+  }
+}
+
+/**
+ * @brief A binary operator fused with its operands, a variable and a constant, e.g. `t0 > 5`.
+ */
+template <Byte R, Byte T0, Byte T1, TypeOf<R> (*Calc)(TypeOf<T0>, TypeOf<T1>)>
+class VarConstOperator : public OperatorBase<R> {
+ public:
+  VarConstOperator(int32_t index, TypeOf<T1> value) : m_index(index), m_value(value) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    const auto &v = stack.GetVar(m_index);
+    if (v != nullptr) {
+      stack.Push(Calc(v.GetValueUnchecked<TypeOf<T0>>(), m_value));
+    } else {
+      stack.Push<TypeOf<R>>();
+    }
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    auto v = stack.GetVar(m_index);
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    r.CopyValidity(v);
+    const auto *in = v.template Values<TypeOf<T0>>();
+    auto *out = r.template Values<TypeOf<R>>();
+    constexpr auto OP = calc::KernelOpOf<TypeOf<R>, TypeOf<T0>, TypeOf<T1>, Calc>();
+    if constexpr (OP != calc::KERNEL_NONE) {
+      static const auto KERNEL = calc::GetConstKernel<TypeOf<R>, TypeOf<T0>>(OP);
+      // Only the arithmetic of `int64_t` can fail.
+      if constexpr (std::is_same_v<TypeOf<R>, int64_t>) {
+        if (!KERNEL(in, m_value, out, size)) {
+          CheckOverflow(stack, r, [&](size_t i) { return calc::ArithChecked<OP>(in[i], m_value, out[i]); });
+        }
+      } else {
+        KERNEL(in, m_value, out, size);
+      }
+      stack.Push(r);
+      return;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      if (!r.IsNull(i)) {
+        out[i] = Calc(in[i], m_value);
+      }
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  bool IsSame(const Operator *op) const override {
+    const auto *v = dynamic_cast<const VarConstOperator<R, T0, T1, Calc> *>(op);
+    return v != nullptr && v->m_index == m_index && v->m_value == m_value;
+  }
+
+  size_t Hash() const override {
+    return (std::hash<int32_t>()(m_index) * 31 + std::hash<TypeOf<T1>>()(m_value)) * 31 + R;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.index = m_index;
+    inst.imm.Set(m_value);
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+    const auto &v = (*tuple)[inst.index];
+    if (v != nullptr) {
+      regs[inst.dst].Set<TypeOf<R>>(Calc(v.GetValueUnchecked<TypeOf<T0>>(), inst.imm.Get<TypeOf<T1>>()));
+    } else {
+      regs[inst.dst].SetNull();
+    }
+    return &inst + 1;
+  }
+
+  int32_t m_index;
+  TypeOf<T1> m_value;
+};
+
 template <Byte R, Byte T, TypeOf<R> (*Calc)(TypeOf<T>)>
 class UnaryOperator : public OperatorBase<R> {
  public:
@@ -92,11 +391,62 @@ class UnaryOperator : public OperatorBase<R> {
     auto v = stack.Get();
     stack.Pop();
     if (v != nullptr) {
-      stack.Push<TypeOf<R>>(Calc(v.GetValue<TypeOf<T>>()));
+      stack.Push<TypeOf<R>>(Calc(v.GetValueUnchecked<TypeOf<T>>()));
     } else {
       stack.Push<TypeOf<R>>();
     }
   }
+
+  void operator()(ColumnStack &stack) const override {
+    auto v = stack.Get();
+    stack.Pop();
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    r.CopyValidity(v);
+    const auto *in = v.template Values<TypeOf<T>>();
+    auto *out = r.template Values<TypeOf<R>>();
+    constexpr auto OP = calc::CastKernelOpOf<TypeOf<R>, TypeOf<T>, Calc>();
+    if constexpr (OP != calc::KERNEL_NONE) {
+      static const auto KERNEL = calc::GetCastKernel<TypeOf<R>, TypeOf<T>>(OP);
+      // Only the checked casts to integers can fail.
+      if (!KERNEL(in, out, size)) {
+        CheckOverflow<R>(stack, r, [&](size_t i) { return calc::CastInRange(in[i], out[i]); });
+      }
+    } else if constexpr (T == TYPE_STRING && (R == TYPE_INT32 || R == TYPE_INT64 || R == TYPE_FLOAT ||
+                                              R == TYPE_DOUBLE) &&
+                         calc::CalcOp<Calc>::OP == calc::KERNEL_CAST) {
+      calc::CastStrings(in, out, r.Validity(), size);
+    } else {
+      // Skip the null rows 64 at a time, which matters for the costly decimals and strings.
+      ForEachSelected(r.Validity(), size, [&](size_t i) { out[i] = Calc(in[i]); });
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 1;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return T;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+    const auto &v = regs[inst.src[0]];
+    if (v.Holds<TypeOf<T>>()) {
+      regs[inst.dst].Set<TypeOf<R>>(Calc(v.Get<TypeOf<T>>()));
+    } else if (v.IsNull()) {
+      regs[inst.dst].SetNull();
+    } else {
+      Instruction::CallOperator(inst, regs, tuple);
+    }
+    return &inst + 1;
+  }
 };
 
 template <Byte R, Byte T>
@@ -116,6 +466,33 @@ class UnarySpecialOperator : public OperatorBase<TYPE_BOOL> {
     stack.Pop();
     stack.Push<bool>(Calc(v));
   }
+
+  void operator()(ColumnStack &stack) const override {
+    auto v = stack.Get();
+    stack.Pop();
+    auto size = stack.BatchSize();
+    auto r = Column::Make<bool>(TYPE_BOOL, size);
+    auto *out = r.Values<bool>();
+    for (size_t i = 0; i < size; ++i) {
+      out[i] = Calc(v.GetOperand(i));
+    }
+    r.SetAllValid();
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 1;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst].Set<bool>(Calc(regs[inst.src[0]].GetOperand()));
+    return &inst + 1;
+  }
 };
 
 template <Byte R, Byte T0, Byte T1, TypeOf<R> (*Calc)(TypeOf<T0>, TypeOf<T1>)>
@@ -127,11 +504,86 @@ class BinaryOperator : public OperatorBase<R> {
     auto v0 = stack.Get();
     stack.Pop();
     if (v0 != nullptr && v1 != nullptr) {
-      stack.Push(Calc(v0.GetValue<TypeOf<T0>>(), v1.GetValue<TypeOf<T1>>()));
+      stack.Push(Calc(v0.GetValueUnchecked<TypeOf<T0>>(), v1.GetValueUnchecked<TypeOf<T1>>()));
     } else {
       stack.Push<TypeOf<R>>();
     }
   }
+
+  void operator()(ColumnStack &stack) const override {
+    auto v1 = stack.Get();
+    stack.Pop();
+    auto v0 = stack.Get();
+    stack.Pop();
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    r.AndValidity(v0, v1);
+    const auto *in0 = v0.template Values<TypeOf<T0>>();
+    const auto *in1 = v1.template Values<TypeOf<T1>>();
+    auto *out = r.template Values<TypeOf<R>>();
+    // The kernels compute the null rows too, which is cheaper than branching.
+    constexpr auto OP = calc::KernelOpOf<TypeOf<R>, TypeOf<T0>, TypeOf<T1>, Calc>();
+    if constexpr (OP != calc::KERNEL_NONE) {
+      static const auto KERNEL = calc::GetKernel<TypeOf<R>, TypeOf<T0>>(OP);
+      // Only the arithmetic of `int64_t` can fail.
+      if constexpr (std::is_same_v<TypeOf<R>, int64_t>) {
+        if (!KERNEL(in0, in1, out, size)) {
+          CheckOverflow(stack, r, [&](size_t i) { return calc::ArithChecked<OP>(in0[i], in1[i], out[i]); });
+        }
+      } else {
+        KERNEL(in0, in1, out, size);
+      }
+      stack.Push(r);
+      return;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      if (!r.IsNull(i)) {
+        out[i] = Calc(in0[i], in1[i]);
+      }
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 2;
+  }
+
+  Byte GetOperandType(int i) const override {
+    return i == 0 ? T0 : T1;
+  }
+
+  const Operator *FuseVarConst(const Operator *var, const Operator *c, OperatorArena &arena) const override {
+    const auto *v = dynamic_cast<const IndexedVarOperator<T0> *>(var);
+    if (v == nullptr || !c->IsConst()) {
+      return nullptr;
+    }
+    OperandStack stack;
+    stack.Reserve(1);
+    (*c)(stack);
+    auto value = stack.Get();
+    if (!value.template Is<TypeOf<T1>>()) {
+      return nullptr;
+    }
+    return arena.New<VarConstOperator<R, T0, T1, Calc>>(v->GetIndex(), value.template GetValueUnchecked<TypeOf<T1>>());
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+    const auto &v0 = regs[inst.src[0]];
+    const auto &v1 = regs[inst.src[1]];
+    if (v0.Holds<TypeOf<T0>>() && v1.Holds<TypeOf<T1>>()) {
+      regs[inst.dst].Set<TypeOf<R>>(Calc(v0.Get<TypeOf<T0>>(), v1.Get<TypeOf<T1>>()));
+    } else if (v0.IsNull() || v1.IsNull()) {
+      regs[inst.dst].SetNull();
+    } else {
+      Instruction::CallOperator(inst, regs, tuple);
+    }
+    return &inst + 1;
+  }
 };
 
 template <Byte R, Byte T0, Byte T1, Operand (*Calc)(TypeOf<T0>, TypeOf<T1>)>
@@ -142,6 +594,55 @@ class BinaryOperatorV2 : public OperatorBase<R> {
     stack.Pop();
     auto v0 = stack.Get();
     stack.Pop();
+    stack.Push(Compute(v0, v1));
+  }
+
+  // The result may be promoted to double at runtime, so the column type is determined by the results.
+  void operator()(ColumnStack &stack) const override {
+    auto v1 = stack.Get();
+    stack.Pop();
+    auto v0 = stack.Get();
+    stack.Pop();
+    auto size = stack.BatchSize();
+    std::vector<Operand> results(size);
+    Byte type = R;
+    for (size_t i = 0; i < size; ++i) {
+      results[i] = Compute(v0.GetOperand(i), v1.GetOperand(i));
+      if (results[i] != nullptr && !results[i].template Is<TypeOf<R>>()) {
+        type = TYPE_DOUBLE;
+      }
+    }
+    auto r = Column::Make(type, size);
+    for (size_t i = 0; i < size; ++i) {
+      r.SetOperand(i, results[i]);
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 2;
+  }
+
+  // Integers are promoted to double while running, so the types are checked then.
+  Byte GetOperandType(int i) const override {
+    if constexpr (R == TYPE_DOUBLE) {
+      return TYPE_NULL;
+    } else {
+      return i == 0 ? T0 : T1;
+    }
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst].SetOperand(Compute(regs[inst.src[0]].GetOperand(), regs[inst.src[1]].GetOperand()));
+    return &inst + 1;
+  }
+
+  static Operand Compute(const Operand &v0, const Operand &v1) {
     if (v0 != nullptr && v1 != nullptr) {
       if(R == TYPE_DOUBLE &&
           (v0.isInt() || v0.isLong()) &&
@@ -163,13 +664,11 @@ class BinaryOperatorV2 : public OperatorBase<R> {
           val1 = (double)v1.GetValue<int64_t>();
         }
 
-        stack.Push(Calc(val0, val1));
-      }else {
-        stack.Push(Calc(v0.GetValue<TypeOf<T0>>(), v1.GetValue<TypeOf<T1>>()));
+        return Calc(val0, val1);
       }
-    } else {
-      stack.Push<TypeOf<R>>();
+      return Calc(v0.GetValue<TypeOf<T0>>(), v1.GetValue<TypeOf<T1>>());
     }
+    return nullptr;
   }
 };
 
@@ -190,26 +689,620 @@ class TertiaryOperator : public OperatorBase<R> {
     auto v0 = stack.Get();
     stack.Pop();
     if (v0 != nullptr && v1 != nullptr && v2 != nullptr) {
-      stack.Push(Calc(v0.GetValue<TypeOf<T0>>(), v1.GetValue<TypeOf<T1>>(), v2.GetValue<TypeOf<T2>>()));
+      stack.Push(Calc(
+          v0.GetValueUnchecked<TypeOf<T0>>(), v1.GetValueUnchecked<TypeOf<T1>>(), v2.GetValueUnchecked<TypeOf<T2>>()
+      ));
     } else {
       stack.Push<TypeOf<R>>();
     }
   }
+
+  void operator()(ColumnStack &stack) const override {
+    auto v2 = stack.Get();
+    stack.Pop();
+    auto v1 = stack.Get();
+    stack.Pop();
+    auto v0 = stack.Get();
+    stack.Pop();
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    r.AndValidity(v0, v1);
+    r.AndValidity(r, v2);
+    const auto *in0 = v0.template Values<TypeOf<T0>>();
+    const auto *in1 = v1.template Values<TypeOf<T1>>();
+    const auto *in2 = v2.template Values<TypeOf<T2>>();
+    auto *out = r.template Values<TypeOf<R>>();
+    for (size_t i = 0; i < size; ++i) {
+      if (!r.IsNull(i)) {
+        out[i] = Calc(in0[i], in1[i], in2[i]);
+      }
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return 3;
+  }
+
+  Byte GetOperandType(int i) const override {
+    return i == 0 ? T0 : (i == 1 ? T1 : T2);
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple) {
+    const auto &v0 = regs[inst.src[0]];
+    const auto &v1 = regs[inst.src[1]];
+    const auto &v2 = regs[inst.src[2]];
+    if (v0.Holds<TypeOf<T0>>() && v1.Holds<TypeOf<T1>>() && v2.Holds<TypeOf<T2>>()) {
+      regs[inst.dst].Set<TypeOf<R>>(Calc(v0.Get<TypeOf<T0>>(), v1.Get<TypeOf<T1>>(), v2.Get<TypeOf<T2>>()));
+    } else if (v0.IsNull() || v1.IsNull() || v2.IsNull()) {
+      regs[inst.dst].SetNull();
+    } else {
+      Instruction::CallOperator(inst, regs, tuple);
+    }
+    return &inst + 1;
+  }
+};
+
+/**
+ * @brief Fold the operands of the same type from left to right by a binary function, e.g. variadic `SUM` and `MIN`.
+ *
+ * The result is null if any of the operands is null.
+ */
+template <Byte R, TypeOf<R> (*Calc)(TypeOf<R>, TypeOf<R>)>
+class VariadicOperator : public OperatorBase<R> {
+ public:
+  VariadicOperator(int arity) : m_arity(arity) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    // Check the nulls first, not to compute anything if there is one.
+    for (int i = 0; i < m_arity; ++i) {
+      if (stack.Peek(i) == nullptr) {
+        stack.Pop(m_arity);
+        stack.Push<TypeOf<R>>();
+        return;
+      }
+    }
+    auto value = stack.Peek(m_arity - 1).template GetValueUnchecked<TypeOf<R>>();
+    for (int i = m_arity - 2; i >= 0; --i) {
+      value = Calc(value, stack.Peek(i).template GetValueUnchecked<TypeOf<R>>());
+    }
+    stack.Pop(m_arity);
+    stack.Push(value);
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    std::vector<Column> columns(m_arity);
+    for (int i = m_arity - 1; i >= 0; --i) {
+      columns[i] = stack.Get();
+      stack.Pop();
+    }
+    auto size = stack.BatchSize();
+    auto r = Column::Make<TypeOf<R>>(R, size);
+    r.CopyValidity(columns[0]);
+    for (int i = 1; i < m_arity; ++i) {
+      r.AndValidity(r, columns[i]);
+    }
+    auto *out = r.template Values<TypeOf<R>>();
+    const auto *in = columns[0].template Values<TypeOf<R>>();
+    constexpr auto OP = calc::KernelOpOf<TypeOf<R>, TypeOf<R>, TypeOf<R>, Calc>();
+    if constexpr (OP != calc::KERNEL_NONE) {
+      static const auto KERNEL = calc::GetKernel<TypeOf<R>, TypeOf<R>>(OP);
+      if (m_arity == 1) {
+        std::copy_n(in, size, out);
+      }
+      // Each step writes to a buffer other than the one it reads, to recheck the step on overflow. The steps alternate
+      // between the two buffers, so that the last one writes `out`.
+      std::unique_ptr<TypeOf<R>[]> temp(m_arity > 2 ? new TypeOf<R>[size] : nullptr);
+      TypeOf<R> *buffers[] = {out, temp.get()};
+      for (int i = 1; i < m_arity; ++i) {
+        const auto *in1 = columns[i].template Values<TypeOf<R>>();
+        auto *acc = buffers[(m_arity - 1 - i) & 1];
+        [[maybe_unused]] bool ok = KERNEL(in, in1, acc, size);
+        // Only the arithmetic of `int64_t` can fail.
+        if constexpr (std::is_same_v<TypeOf<R>, int64_t>) {
+          if (!ok) {
+            CheckOverflow(stack, r, [&](size_t j) { return calc::ArithChecked<OP>(in[j], in1[j], acc[j]); });
+          }
+        }
+        in = acc;
+      }
+    } else {
+      ForEachSelected(r.Validity(), size, [&](size_t j) { out[j] = in[j]; });
+      for (int i = 1; i < m_arity; ++i) {
+        const auto *in1 = columns[i].template Values<TypeOf<R>>();
+        ForEachSelected(r.Validity(), size, [&](size_t j) { out[j] = Calc(out[j], in1[j]); });
+      }
+    }
+    stack.Push(r);
+  }
+
+  int GetArity() const override {
+    return m_arity;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return R;
+  }
+
+  bool IsSame(const Operator *op) const override {
+    const auto *v = dynamic_cast<const VariadicOperator<R, Calc> *>(op);
+    return v != nullptr && v->m_arity == m_arity;
+  }
+
+  size_t Hash() const override {
+    return std::hash<int>()(m_arity) * 31 + R;
+  }
+
+  // The operands are in the registers from `dst`, as they are in the stack.
+  void Lower(Instruction &inst) const override {
+    inst.index = m_arity;
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    const auto *v = regs + inst.dst;
+    for (int i = 0; i < inst.index; ++i) {
+      if (v[i].IsNull()) {
+        regs[inst.dst].SetNull();
+        return &inst + 1;
+      }
+    }
+    auto value = v[0].Get<TypeOf<R>>();
+    for (int i = 1; i < inst.index; ++i) {
+      value = Calc(value, v[i].Get<TypeOf<R>>());
+    }
+    regs[inst.dst].Set<TypeOf<R>>(value);
+    return &inst + 1;
+  }
+
+  int m_arity;
 };
 
 class NotOperator : public OperatorBase<TYPE_BOOL> {
  public:
   void operator()(OperandStack &stack) const override;
+
+  void operator()(ColumnStack &stack) const override;
+
+  int GetArity() const override {
+    return 1;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return TYPE_BOOL;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple);
 };
 
 class AndOperator : public OperatorBase<TYPE_BOOL> {
  public:
   void operator()(OperandStack &stack) const override;
+
+  void operator()(ColumnStack &stack) const override;
+
+  int GetArity() const override {
+    return 2;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return TYPE_BOOL;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple);
 };
 
 class OrOperator : public OperatorBase<TYPE_BOOL> {
  public:
   void operator()(OperandStack &stack) const override;
+
+  void operator()(ColumnStack &stack) const override;
+
+  int GetArity() const override {
+    return 2;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return TYPE_BOOL;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, const Tuple *tuple);
+};
+
+/**
+ * @brief Variadic `AND` for `V` = false, or `OR` for `V` = true, which is `V` if any operand is `V`, or null if none is
+ * but any is null.
+ *
+ * If short-circuited by `VariadicJumpIfOperator`s, the selections pushed by them are popped in batch mode.
+ */
+template <bool V>
+class VariadicLogicOperator : public OperatorBase<TYPE_BOOL> {
+ public:
+  VariadicLogicOperator(int arity, int selections = 0) : m_arity(arity), m_selections(selections) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    bool has_null = false;
+    for (int i = 0; i < m_arity; ++i) {
+      const auto &v = stack.Peek(i);
+      if (v == nullptr) {
+        has_null = true;
+      } else if (v.GetValueUnchecked<bool>() == V) {
+        stack.Pop(m_arity);
+        stack.Push(V);
+        return;
+      }
+    }
+    stack.Pop(m_arity);
+    if (has_null) {
+      stack.Push<bool>();
+    } else {
+      stack.Push(!V);
+    }
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    Combine(stack, m_arity);
+    for (int i = 0; i < m_selections; ++i) {
+      stack.PopSelection();
+    }
+  }
+
+  int GetArity() const override {
+    return m_arity;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return TYPE_BOOL;
+  }
+
+  bool IsSame(const Operator *op) const override {
+    const auto *v = dynamic_cast<const VariadicLogicOperator<V> *>(op);
+    return v != nullptr && v->m_arity == m_arity && v->m_selections == m_selections;
+  }
+
+  size_t Hash() const override {
+    return std::hash<int>()(m_arity) * 31 + V;
+  }
+
+  // The operands are in the registers from `dst`, as they are in the stack.
+  void Lower(Instruction &inst) const override {
+    inst.index = m_arity;
+    inst.exec = Exec;
+  }
+
+  /**
+   * @brief Pop the columns of `arity` operands and push the result, 64 rows a word of the bitmaps at a time.
+   */
+  static void Combine(ColumnStack &stack, int arity) {
+    auto size = stack.BatchSize();
+    auto words = Column::ValidityWords(size);
+    // The rows of any operand being `V`, and the rows of any operand being null.
+    std::vector<uint64_t> decided(words, 0);
+    std::vector<uint64_t> nulls(words, 0);
+    for (int k = 0; k < arity; ++k) {
+      const auto &v = stack.Get();
+      const auto *values = v.Values<bool>();
+      const auto *validity = v.Validity();
+      for (size_t w = 0; w < words; ++w) {
+        auto n = std::min<size_t>(64, size - (w << 6));
+        uint64_t bits = 0;
+        for (size_t j = 0; j < n; ++j) {
+          bits |= static_cast<uint64_t>(values[(w << 6) + j] == V) << j;
+        }
+        decided[w] |= bits & validity[w];
+        nulls[w] |= ~validity[w];
+      }
+      stack.Pop();
+    }
+    auto r = Column::Make<bool>(TYPE_BOOL, size);
+    auto *out = r.Values<bool>();
+    for (size_t i = 0; i < size; ++i) {
+      out[i] = (((decided[i >> 6] >> (i & 63)) & 1) != 0) == V;
+    }
+    auto *validity = r.Validity();
+    for (size_t w = 0; w < words; ++w) {
+      validity[w] = decided[w] | ~nulls[w];
+    }
+    stack.Push(r);
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    const auto *v = regs + inst.dst;
+    bool has_null = false;
+    for (int i = 0; i < inst.index; ++i) {
+      if (v[i].IsNull()) {
+        has_null = true;
+      } else if (v[i].Get<bool>() == V) {
+        regs[inst.dst].Set(V);
+        return &inst + 1;
+      }
+    }
+    if (has_null) {
+      regs[inst.dst].SetNull();
+    } else {
+      regs[inst.dst].Set(!V);
+    }
+    return &inst + 1;
+  }
+
+  int m_arity;
+  int m_selections;
+};
+
+/**
+ * @brief Save the operand on the top of the stack to a temporary slot, leaving the stack unchanged.
+ */
+class StoreTempOperator : public Operator {
+ public:
+  StoreTempOperator(Byte type, int32_t index) : m_type(type), m_index(index) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    stack.SetTemp(m_index, stack.Get());
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    stack.SetTemp(m_index, stack.Get());
+  }
+
+  Byte GetType() const override {
+    return m_type;
+  }
+
+  int32_t GetIndex() const {
+    return m_index;
+  }
+
+  int GetArity() const override {
+    return 1;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return m_type;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.index = m_index;
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.index] = regs[inst.src[0]];
+    return &inst + 1;
+  }
+
+  Byte m_type;
+  int32_t m_index;
+};
+
+/**
+ * @brief Push the operand saved in a temporary slot by `StoreTempOperator`.
+ */
+class LoadTempOperator : public Operator {
+ public:
+  LoadTempOperator(Byte type, int32_t index) : m_type(type), m_index(index) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    stack.Push(stack.GetTemp(m_index));
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    stack.Push(stack.GetTemp(m_index));
+  }
+
+  Byte GetType() const override {
+    return m_type;
+  }
+
+  int32_t GetIndex() const {
+    return m_index;
+  }
+
+  int GetArity() const override {
+    return 0;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.index = m_index;
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    regs[inst.dst] = regs[inst.index];
+    return &inst + 1;
+  }
+
+  Byte m_type;
+  int32_t m_index;
+};
+
+/**
+ * @brief Skip the following operators if the operand on the top of the stack is `V`, leaving it as the result.
+ *
+ * In batch mode, the rows whose operands are not `V` are selected to evaluate the following operators, and all of them
+ * are skipped only if no row is selected. The selection is popped by `ShortCircuitAndOperator` or
+ * `ShortCircuitOrOperator` at the end of skipping.
+ */
+template <bool V>
+class JumpIfOperator : public OperatorBase<TYPE_BOOL> {
+ public:
+  JumpIfOperator(size_t skip) : m_skip(skip) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    auto v = stack.Get();
+    if (v != nullptr && v.GetValueUnchecked<bool>() == V) {
+      stack.Skip(m_skip);
+    }
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    auto next = SelectUndecided(stack);
+    if (next != nullptr) {
+      stack.PushSelection(next);
+    } else {
+      stack.Skip(m_skip);
+    }
+  }
+
+  int GetArity() const override {
+    return 1;
+  }
+
+  Byte GetOperandType([[maybe_unused]] int i) const override {
+    return TYPE_BOOL;
+  }
+
+  void Lower(Instruction &inst) const override {
+    inst.index = static_cast<int32_t>(m_skip);
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    const auto &v = regs[inst.src[0]];
+    if (v.Holds<bool>() && v.Get<bool>() == V) {
+      return &inst + 1 + inst.index;
+    }
+    return &inst + 1;
+  }
+
+ protected:
+  size_t m_skip;
+
+  /**
+   * @brief Select the rows of the selection whose operands on the top of the stack are not `V`.
+   *
+   * @return the selection, or `nullptr` if no row is selected
+   */
+  static std::shared_ptr<uint64_t[]> SelectUndecided(const ColumnStack &stack) {
+    const auto &v = stack.Get();
+    auto size = stack.BatchSize();
+    const auto *values = v.Values<bool>();
+    const auto *selection = stack.GetSelection();
+    std::shared_ptr<uint64_t[]> next(new uint64_t[Column::ValidityWords(size)]());
+    bool any = false;
+    for (size_t i = 0; i < size; ++i) {
+      if (selection != nullptr && ((selection[i >> 6] >> (i & 63)) & 1) == 0) {
+        continue;
+      }
+      if (v.IsNull(i) || values[i] != V) {
+        next[i >> 6] |= (1ULL << (i & 63));
+        any = true;
+      }
+    }
+    return any ? next : nullptr;
+  }
+};
+
+/**
+ * @brief The `AND` operator following a `JumpIfOperator<false>`.
+ */
+class ShortCircuitAndOperator : public AndOperator {
+ public:
+  using AndOperator::operator();
+
+  void operator()(ColumnStack &stack) const override {
+    AndOperator::operator()(stack);
+    stack.PopSelection();
+  }
+};
+
+/**
+ * @brief The `OR` operator following a `JumpIfOperator<true>`.
+ */
+class ShortCircuitOrOperator : public OrOperator {
+ public:
+  using OrOperator::operator();
+
+  void operator()(ColumnStack &stack) const override {
+    OrOperator::operator()(stack);
+    stack.PopSelection();
+  }
+};
+
+/**
+ * @brief Skip the following operands of a `VariadicLogicOperator<V>` and itself, if the operand on the top is `V`.
+ *
+ * On skipping, the operands pushed (the top one is the `pos`th) are replaced by the result `V`. In batch mode, the rows
+ * are selected as `JumpIfOperator` does, and all are skipped only if no row is selected, with the result combined of the
+ * operands pushed and the selections pushed by the jumps before popped.
+ */
+template <bool V>
+class VariadicJumpIfOperator : public JumpIfOperator<V> {
+ public:
+  VariadicJumpIfOperator(size_t skip, int pos, int selections)
+      : JumpIfOperator<V>(skip), m_pos(pos), m_selections(selections) {
+  }
+
+  void operator()(OperandStack &stack) const override {
+    const auto &v = stack.Peek(0);
+    if (v != nullptr && v.GetValueUnchecked<bool>() == V) {
+      stack.Pop(m_pos + 1);
+      stack.Push(V);
+      stack.Skip(this->m_skip);
+    }
+  }
+
+  void operator()(ColumnStack &stack) const override {
+    auto next = JumpIfOperator<V>::SelectUndecided(stack);
+    if (next != nullptr) {
+      stack.PushSelection(next);
+      return;
+    }
+    for (int i = 0; i < m_selections; ++i) {
+      stack.PopSelection();
+    }
+    VariadicLogicOperator<V>::Combine(stack, m_pos + 1);
+    stack.Skip(this->m_skip);
+  }
+
+  // The result is written to the register of the first operand.
+  void Lower(Instruction &inst) const override {
+    inst.index = static_cast<int32_t>(this->m_skip);
+    inst.dst = inst.src[0] - m_pos;
+    inst.exec = Exec;
+  }
+
+ private:
+  static const Instruction *Exec(const Instruction &inst, Slot *regs, [[maybe_unused]] const Tuple *tuple) {
+    const auto &v = regs[inst.src[0]];
+    if (v.Holds<bool>() && v.Get<bool>() == V) {
+      regs[inst.dst].Set(V);
+      return &inst + 1 + inst.index;
+    }
+    return &inst + 1;
+  }
+
+  int m_pos;
+  int m_selections;
 };
 
 }  // namespace dingodb::expr
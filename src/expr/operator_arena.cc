@@ -0,0 +1,49 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "operator_arena.h"
+
+#include <algorithm>
+
+#include "operator.h"
+
+namespace dingodb::expr {
+
+void OperatorArena::Clear() {
+  for (auto it = m_operators.rbegin(); it != m_operators.rend(); ++it) {
+    (*it)->~Operator();
+  }
+  m_operators.clear();
+  m_block = 0;
+  m_offset = 0;
+}
+
+void *OperatorArena::Allocate(size_t size, size_t align) {
+  // The blocks are aligned to `alignof(std::max_align_t)`, which is enough for any operator.
+  for (; m_block < m_blocks.size(); ++m_block, m_offset = 0) {
+    auto offset = (m_offset + align - 1) & ~(align - 1);
+    if (offset + size <= m_block_sizes[m_block]) {
+      m_offset = offset + size;
+      return m_blocks[m_block].get() + offset;
+    }
+  }
+  auto block_size = std::max(size, BLOCK_SIZE);
+  m_blocks.emplace_back(new char[block_size]);
+  m_block_sizes.push_back(block_size);
+  m_offset = size;
+  return m_blocks.back().get();
+}
+
+}  // namespace dingodb::expr
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _EXPR_OPERATOR_ARENA_H_
+#define _EXPR_OPERATOR_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dingodb::expr {
+
+class Operator;
+
+/**
+ * @brief Operators of an expression, allocated contiguously in blocks and destroyed all at once.
+ *
+ * The blocks are kept after clearing, so decoding the next expression allocates nothing unless it needs more.
+ */
+class OperatorArena {
+ public:
+  OperatorArena() : m_block(0), m_offset(0) {
+  }
+
+  ~OperatorArena() {
+    Clear();
+  }
+
+  OperatorArena(const OperatorArena &) = delete;
+  OperatorArena &operator=(const OperatorArena &) = delete;
+
+  template <typename Op, typename... Args>
+  const Op *New(Args &&...args) {
+    auto *op = new (Allocate(sizeof(Op), alignof(Op))) Op(std::forward<Args>(args)...);
+    m_operators.push_back(op);
+    return op;
+  }
+
+  /**
+   * @brief Destroy all the operators in the arena.
+   */
+  void Clear();
+
+ private:
+  static const size_t BLOCK_SIZE = 4096;
+
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  std::vector<size_t> m_block_sizes;
+  size_t m_block;
+  size_t m_offset;
+  std::vector<const Operator *> m_operators;
+
+  void *Allocate(size_t size, size_t align);
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_OPERATOR_ARENA_H_ */
@@ -14,6 +14,10 @@
 
 #include "operator_vector.h"
 
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
 #include "codec.h"
 #include "exception.h"
 #include "operators.h"
@@ -23,42 +27,18 @@
 namespace dingodb::expr {
 
 static const Byte NULL_PREFIX  = 0x00;
-static const Byte NULL_INT32   = NULL_PREFIX | TYPE_INT32;
-static const Byte NULL_INT64   = NULL_PREFIX | TYPE_INT64;
-static const Byte NULL_BOOL    = NULL_PREFIX | TYPE_BOOL;
-static const Byte NULL_FLOAT   = NULL_PREFIX | TYPE_FLOAT;
-static const Byte NULL_DOUBLE  = NULL_PREFIX | TYPE_DOUBLE;
-static const Byte NULL_DECIMAL = NULL_PREFIX | TYPE_DECIMAL;
-static const Byte NULL_STRING  = NULL_PREFIX | TYPE_STRING;
-static const Byte NULL_DATE    = NULL_PREFIX | TYPE_DATE;
-static const Byte NULL_TIMESTAMP    = NULL_PREFIX | TYPE_TIMESTAMP;
 
 static const Byte CONST_PREFIX  = 0x10;
-static const Byte CONST_INT32   = CONST_PREFIX | TYPE_INT32;
-static const Byte CONST_INT64   = CONST_PREFIX | TYPE_INT64;
 static const Byte CONST_BOOL    = CONST_PREFIX | TYPE_BOOL;
-static const Byte CONST_FLOAT   = CONST_PREFIX | TYPE_FLOAT;
-static const Byte CONST_DOUBLE  = CONST_PREFIX | TYPE_DOUBLE;
-static const Byte CONST_DECIMAL = CONST_PREFIX | TYPE_DECIMAL;
-static const Byte CONST_STRING  = CONST_PREFIX | TYPE_STRING;
-static const Byte CONST_DATE  = CONST_PREFIX | TYPE_DATE;
-static const Byte CONST_TIMESTAMP  = CONST_PREFIX | TYPE_TIMESTAMP;
 
 static const Byte CONST_N_PREFIX = 0x20;
 static const Byte CONST_N_INT32  = CONST_N_PREFIX | TYPE_INT32;
 static const Byte CONST_N_INT64  = CONST_N_PREFIX | TYPE_INT64;
 static const Byte CONST_N_BOOL   = CONST_N_PREFIX | TYPE_BOOL;
+// Decimal in binary form.
+static const Byte CONST_N_DECIMAL = CONST_N_PREFIX | TYPE_DECIMAL;
 
 static const Byte VAR_I_PREFIX  = 0x30;
-static const Byte VAR_I_INT32   = VAR_I_PREFIX | TYPE_INT32;
-static const Byte VAR_I_INT64   = VAR_I_PREFIX | TYPE_INT64;
-static const Byte VAR_I_BOOL    = VAR_I_PREFIX | TYPE_BOOL;
-static const Byte VAR_I_FLOAT   = VAR_I_PREFIX | TYPE_FLOAT;
-static const Byte VAR_I_DOUBLE  = VAR_I_PREFIX | TYPE_DOUBLE;
-static const Byte VAR_I_DECIMAL = VAR_I_PREFIX | TYPE_DECIMAL;
-static const Byte VAR_I_STRING  = VAR_I_PREFIX | TYPE_STRING;
-static const Byte VAR_I_DATE    = VAR_I_PREFIX | TYPE_DATE;
-static const Byte VAR_I_TIMESTAMP    = VAR_I_PREFIX | TYPE_TIMESTAMP;
 
 static const Byte POS = 0x81;
 static const Byte NEG = 0x82;
@@ -87,6 +67,12 @@ static const Byte ABS_C = 0xB4;
 static const Byte NOT = 0x51;
 static const Byte AND = 0x52;
 static const Byte OR  = 0x53;
+static const Byte AND_FUN = 0x54;
+static const Byte OR_FUN  = 0x55;
+
+// The higher 4 bits of the type byte of `SUM`, `VARG_MIN` and `VARG_MAX`, which share the codes with `POS`, `MIN` and
+// `MAX`.
+static const Byte VARIADIC = 0x10;
 
 static const Byte CAST   = 0xF0;
 static const Byte CAST_C = 0xFC;
@@ -94,334 +80,626 @@ static const Byte FUN    = 0xF1;
 
 static const Byte EOE = 0x00;
 
+/**
+ * @brief The decoding functions indexed by the code byte, `nullptr` for invalid codes.
+ */
+struct OperatorVector::DecodeTable {
+  DecodeFun funs[256];
+
+  constexpr DecodeTable() : funs() {
+    SetTyped<NULL_PREFIX, DecodeNull>();
+    SetTyped<CONST_PREFIX, DecodeConst>();
+    funs[CONST_BOOL] = DecodeOperator<OP_CONST_TRUE>;
+    funs[CONST_N_INT32] = DecodeConstN<TYPE_INT32>;
+    funs[CONST_N_INT64] = DecodeConstN<TYPE_INT64>;
+    funs[CONST_N_BOOL] = DecodeOperator<OP_CONST_FALSE>;
+    funs[CONST_N_DECIMAL] = DecodeConstDecimalBinary;
+    SetTyped<VAR_I_PREFIX, DecodeVar>();
+    funs[POS] = DecodeByTypeOrVariadic<OP_POS, MAKE_SUM>;
+    funs[NEG] = DecodeByType<OP_NEG>;
+    funs[ADD] = DecodeByType<OP_ADD>;
+    funs[SUB] = DecodeByType<OP_SUB>;
+    funs[MUL] = DecodeByType<OP_MUL>;
+    funs[DIV] = DecodeByType<OP_DIV>;
+    funs[MOD] = DecodeByType<OP_MOD>;
+    funs[EQ] = DecodeByType<OP_EQ>;
+    funs[GE] = DecodeByType<OP_GE>;
+    funs[GT] = DecodeByType<OP_GT>;
+    funs[LE] = DecodeByType<OP_LE>;
+    funs[LT] = DecodeByType<OP_LT>;
+    funs[NE] = DecodeByType<OP_NE>;
+    funs[IS_NULL] = DecodeByType<OP_IS_NULL>;
+    funs[IS_TRUE] = DecodeByType<OP_IS_TRUE>;
+    funs[IS_FALSE] = DecodeByType<OP_IS_FALSE>;
+    funs[MIN] = DecodeByTypeOrVariadic<OP_MIN, MAKE_VARG_MIN>;
+    funs[MAX] = DecodeByTypeOrVariadic<OP_MAX, MAKE_VARG_MAX>;
+    funs[ABS] = DecodeByType<OP_ABS>;
+    funs[ABS_C] = DecodeByType<OP_ABS_CHECK>;
+    funs[NOT] = DecodeOperator<OP_NOT>;
+    funs[AND] = DecodeOperator<OP_AND>;
+    funs[OR] = DecodeOperator<OP_OR>;
+    funs[AND_FUN] = DecodeVariadic<MakeAndFun>;
+    funs[OR_FUN] = DecodeVariadic<MakeOrFun>;
+    funs[CAST] = DecodeCast<OP_CAST>;
+    funs[CAST_C] = DecodeCast<OP_CAST_CHECK>;
+    funs[FUN] = DecodeFunction;
+  }
+
+  // Set the function of each type, for the codes of the prefix.
+  template <Byte PREFIX, template <Byte> class F>
+  constexpr void SetTyped() {
+    funs[PREFIX | TYPE_INT32] = F<TYPE_INT32>::Decode;
+    funs[PREFIX | TYPE_INT64] = F<TYPE_INT64>::Decode;
+    funs[PREFIX | TYPE_BOOL] = F<TYPE_BOOL>::Decode;
+    funs[PREFIX | TYPE_FLOAT] = F<TYPE_FLOAT>::Decode;
+    funs[PREFIX | TYPE_DOUBLE] = F<TYPE_DOUBLE>::Decode;
+    funs[PREFIX | TYPE_DECIMAL] = F<TYPE_DECIMAL>::Decode;
+    funs[PREFIX | TYPE_STRING] = F<TYPE_STRING>::Decode;
+    funs[PREFIX | TYPE_DATE] = F<TYPE_DATE>::Decode;
+    funs[PREFIX | TYPE_TIMESTAMP] = F<TYPE_TIMESTAMP>::Decode;
+  }
+
+  template <Byte T>
+  struct DecodeNull {
+    static const Byte *Decode(OperatorVector &vector, const Byte *p, [[maybe_unused]] const Byte *end) {
+      vector.Add(OP_NULL[T]);
+      return p;
+    }
+  };
+
+  template <Byte T>
+  struct DecodeConst {
+    static const Byte *Decode(OperatorVector &vector, const Byte *p, const Byte *end) {
+      if constexpr (T == TYPE_BOOL) {
+        // Overridden by `CONST_BOOL`.
+        return nullptr;
+      } else {
+        TypeOf<T> v;
+        p = DecodeValue(v, p, end);
+        vector.Add(vector.m_arena.New<ConstOperator<T>>(v));
+        return p;
+      }
+    }
+  };
+
+  template <Byte T>
+  struct DecodeVar {
+    static const Byte *Decode(OperatorVector &vector, const Byte *p, const Byte *end) {
+      int32_t index;
+      p = DecodeValue(index, p, end);
+      vector.Add(vector.m_arena.New<IndexedVarOperator<T>>(index));
+      return p;
+    }
+  };
+
+  template <Byte T>
+  static const Byte *DecodeConstN(OperatorVector &vector, const Byte *p, const Byte *end) {
+    TypeOf<T> v;
+    p = DecodeValue(v, p, end);
+    vector.Add(vector.m_arena.New<ConstOperator<T>>(-v));
+    return p;
+  }
+
+  static const Byte *DecodeConstDecimalBinary(OperatorVector &vector, const Byte *p, const Byte *end) {
+    DecimalP v;
+    p = DecodeDecimalBinary(v, p, end);
+    vector.Add(vector.m_arena.New<ConstOperator<TYPE_DECIMAL>>(v));
+    return p;
+  }
+
+  template <const Operator *const &OP>
+  static const Byte *DecodeOperator(OperatorVector &vector, const Byte *p, [[maybe_unused]] const Byte *end) {
+    vector.Add(OP);
+    return p;
+  }
+
+  template <const Operator *const (&OPS)[TYPE_NUM]>
+  static const Byte *DecodeByType(OperatorVector &vector, const Byte *p, const Byte *end) {
+    if (p < end && vector.AddOperatorByType(OPS, *p)) {
+      return p + 1;
+    }
+    return nullptr;
+  }
+
+  // The arity follows the code, which must be positive.
+  template <VariadicMaker MAKE>
+  static const Byte *DecodeVariadic(OperatorVector &vector, const Byte *p, const Byte *end) {
+    int32_t arity;
+    p = DecodeValue(arity, p, end);
+    if (arity <= 0) {
+      return nullptr;
+    }
+    vector.Add(MAKE(arity, vector.m_arena));
+    return p;
+  }
+
+  template <const Operator *const (&OPS)[TYPE_NUM], const VariadicMaker (&MAKERS)[TYPE_NUM]>
+  static const Byte *DecodeByTypeOrVariadic(OperatorVector &vector, const Byte *p, const Byte *end) {
+    if (p < end && (*p & 0xF0) == VARIADIC) {
+      Byte type = *p & 0x0F;
+      if (type >= TYPE_NUM || MAKERS[type] == nullptr) {
+        return nullptr;
+      }
+      int32_t arity;
+      p = DecodeValue(arity, p + 1, end);
+      if (arity <= 0) {
+        return nullptr;
+      }
+      vector.Add(MAKERS[type](arity, vector.m_arena));
+      return p;
+    }
+    return DecodeByType<OPS>(vector, p, end);
+  }
+
+  template <const Operator *const (&OPS)[TYPE_NUM][TYPE_NUM]>
+  static const Byte *DecodeCast(OperatorVector &vector, const Byte *p, const Byte *end) {
+    if (p < end && vector.AddCastOperator(OPS, *p)) {
+      return p + 1;
+    }
+    return nullptr;
+  }
+
+  static const Byte *DecodeFunction(OperatorVector &vector, const Byte *p, const Byte *end) {
+    if (p < end && vector.AddFunOperator(*p)) {
+      return p + 1;
+    }
+    return nullptr;
+  }
+};
+
 const Byte *OperatorVector::Decode(const Byte code[], size_t len) {
+  static constexpr DecodeTable DECODE_TABLE;
   Release();
-  bool successful = true;
-  const Byte *p   = code;
-  const Byte *b;
-  while (successful && p < code + len) {
-    b = p;
-    switch (*p) {
-    case NULL_INT32:
-      ++p;
-      Add(OP_NULL[TYPE_INT32]);
-      break;
-    case NULL_INT64:
-      ++p;
-      Add(OP_NULL[TYPE_INT64]);
-      break;
-    case NULL_BOOL:
-      ++p;
-      Add(OP_NULL[TYPE_BOOL]);
-      break;
-    case NULL_FLOAT:
-      ++p;
-      Add(OP_NULL[TYPE_FLOAT]);
-      break;
-    case NULL_DOUBLE:
-      ++p;
-      Add(OP_NULL[TYPE_DOUBLE]);
-      break;
-    case NULL_STRING:
-      ++p;
-      Add(OP_NULL[TYPE_STRING]);
-      break;
-    case NULL_DECIMAL:
+  const Byte *p = code;
+  const Byte *end = code + len;
+  while (p < end) {
+    const Byte *b = p;
+    if (*p == EOE) {
       ++p;
-      Add(OP_NULL[TYPE_DECIMAL]);
-      break;
-    case NULL_DATE:
-      ++p;
-      Add(OP_NULL[TYPE_DATE]);
-      break;
-    case NULL_TIMESTAMP:
-      ++p;
-      Add(OP_NULL[TYPE_TIMESTAMP]);
-      break;
-    case CONST_INT32: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_INT32>(v));
       break;
     }
-    case CONST_INT64: {
-      ++p;
-      int64_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_INT64>(v));
-      break;
+    auto fun = DECODE_TABLE.funs[*p];
+    p = (fun != nullptr ? fun(*this, p + 1, end) : nullptr);
+    if (p == nullptr) {
+      throw UnknownCode(b, end - b);
     }
-    case CONST_BOOL:
-      ++p;
-      Add(OP_CONST_TRUE);
-      break;
-    case CONST_FLOAT: {
-      ++p;
-      float v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_FLOAT>(v));
-      break;
+  }
+  // Check the types before optimizing, which may evaluate the operators.
+  Verify();
+  Optimize();
+  FuseVarConsts();
+  EliminateCommonSubexpressions();
+  AddShortCircuits();
+  CalcMaxDepth();
+  return p;
+}
+
+void OperatorVector::CalcMaxDepth() {
+  size_t depth = 0;
+  m_max_depth = 0;
+  for (const auto *op : m_vector) {
+    size_t arity = op->GetArity();
+    if (depth < arity) {
+      throw ExprError("Not enough operands for operator, " + std::to_string(arity) + " required.");
     }
-    case CONST_DOUBLE: {
-      ++p;
-      double v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_DOUBLE>(v));
-      break;
+    depth = depth - arity + 1;
+    m_max_depth = std::max(m_max_depth, depth);
+  }
+  m_result_num = depth;
+}
+
+void OperatorVector::Verify() {
+  // The type of each operand on the stack, `TYPE_NULL` for null constants, and the index of the variable pushing it.
+  struct Entry {
+    Byte type;
+    int32_t var;
+  };
+  std::vector<Entry> stack;
+  m_max_depth = 0;
+  for (const auto *op : m_vector) {
+    size_t arity = op->GetArity();
+    if (stack.size() < arity) {
+      throw ExprError("Not enough operands for operator, " + std::to_string(arity) + " required.");
     }
-    case CONST_DECIMAL: {
-      ++p;
-      DecimalP v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_DECIMAL>(v));
-      break;
+    auto first = stack.size() - arity;
+    for (size_t i = 0; i < arity; ++i) {
+      auto type = op->GetOperandType(static_cast<int>(i));
+      const auto &e = stack[first + i];
+      if (type == TYPE_NULL || e.type == TYPE_NULL) {
+        continue;
+      }
+      if (e.type != type) {
+        throw ExprError(
+            "Operand " + std::to_string(i) + " of operator is of type " + TypeName(e.type) + ", but " +
+            TypeName(type) + " required."
+        );
+      }
+      // Only the variables got as values are required to be of the types, others are passed through as they are.
+      if (e.var >= 0) {
+        AddVarType(e.var, type);
+      }
     }
-    case CONST_STRING: {
-      ++p;
-      String v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_STRING>(v));
-      break;
+    stack.resize(first);
+    auto type = op->GetType();
+    bool is_null = (type < TYPE_NUM && op == OP_NULL[type]);
+    auto var = op->GetVarIndex();
+    stack.push_back({is_null ? TYPE_NULL : type, var});
+    // Variables passed through are of any type, but must be there all the same.
+    if (var >= 0 && m_var_types.size() <= static_cast<size_t>(var)) {
+      m_var_types.resize(var + 1, TYPE_NULL);
     }
-    case CONST_DATE: {
-      ++p;
-      Date v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_DATE>(v));
-      break;
+    m_max_depth = std::max(m_max_depth, stack.size());
+  }
+  m_result_num = stack.size();
+}
+
+void OperatorVector::AddVarType(int32_t index, Byte type) {
+  if (m_var_types.size() <= static_cast<size_t>(index)) {
+    m_var_types.resize(index + 1, TYPE_NULL);
+  }
+  auto &var_type = m_var_types[index];
+  if (var_type != TYPE_NULL && var_type != type) {
+    throw ExprError(
+        "Variable " + std::to_string(index) + " is used as both " + TypeName(var_type) + " and " + TypeName(type) + "."
+    );
+  }
+  var_type = type;
+}
+
+// Make a constant operator of the specified type, `nullptr` if the value is not of the type.
+static const Operator *MakeConstOperator(Byte type, const Operand &v, OperatorArena &arena) {
+  if (v == nullptr) {
+    return nullptr;
+  }
+  switch (type) {
+  case TYPE_INT32:
+    return v.Is<TypeOf<TYPE_INT32>>() ? arena.New<ConstOperator<TYPE_INT32>>(v.GetValue<TypeOf<TYPE_INT32>>()) : nullptr;
+  case TYPE_INT64:
+    return v.Is<TypeOf<TYPE_INT64>>() ? arena.New<ConstOperator<TYPE_INT64>>(v.GetValue<TypeOf<TYPE_INT64>>()) : nullptr;
+  case TYPE_BOOL:
+    return v.Is<TypeOf<TYPE_BOOL>>() ? arena.New<ConstOperator<TYPE_BOOL>>(v.GetValue<TypeOf<TYPE_BOOL>>()) : nullptr;
+  case TYPE_FLOAT:
+    return v.Is<TypeOf<TYPE_FLOAT>>() ? arena.New<ConstOperator<TYPE_FLOAT>>(v.GetValue<TypeOf<TYPE_FLOAT>>()) : nullptr;
+  case TYPE_DOUBLE:
+    return v.Is<TypeOf<TYPE_DOUBLE>>() ? arena.New<ConstOperator<TYPE_DOUBLE>>(v.GetValue<TypeOf<TYPE_DOUBLE>>()) : nullptr;
+  case TYPE_DECIMAL:
+    return v.Is<TypeOf<TYPE_DECIMAL>>() ? arena.New<ConstOperator<TYPE_DECIMAL>>(v.GetValue<TypeOf<TYPE_DECIMAL>>())
+                                        : nullptr;
+  case TYPE_STRING:
+    return v.Is<TypeOf<TYPE_STRING>>() ? arena.New<ConstOperator<TYPE_STRING>>(v.GetValue<TypeOf<TYPE_STRING>>()) : nullptr;
+  case TYPE_DATE:
+    return v.Is<TypeOf<TYPE_DATE>>() ? arena.New<ConstOperator<TYPE_DATE>>(v.GetValue<TypeOf<TYPE_DATE>>()) : nullptr;
+  case TYPE_TIMESTAMP:
+    return v.Is<TypeOf<TYPE_TIMESTAMP>>() ? arena.New<ConstOperator<TYPE_TIMESTAMP>>(v.GetValue<TypeOf<TYPE_TIMESTAMP>>())
+                                          : nullptr;
+  default:
+    return nullptr;
+  }
+}
+
+// Check if the operator is a variadic `AND` or `OR`.
+static bool IsVariadicLogic(const Operator *op) {
+  return dynamic_cast<const VariadicLogicOperator<false> *>(op) != nullptr ||
+         dynamic_cast<const VariadicLogicOperator<true> *>(op) != nullptr;
+}
+
+// Check if the operator is a constant of the bool value.
+static bool IsConstBool(const Operator *op, bool value) {
+  if (!op->IsConst() || op->GetType() != TYPE_BOOL) {
+    return false;
+  }
+  OperandStack stack;
+  stack.Reserve(1);
+  (*op)(stack);
+  auto v = stack.Get();
+  return v != nullptr && v.GetValue<bool>() == value;
+}
+
+const Operator *OperatorVector::Fold(
+    std::vector<const Operator *>::const_iterator first,
+    std::vector<const Operator *>::const_iterator last,
+    const Operator *op
+) {
+  OperandStack stack;
+  // Not deeper than the whole expression.
+  stack.Reserve(m_max_depth);
+  Operand v;
+  try {
+    for (auto it = first; it != last; ++it) {
+      (**it)(stack);
     }
-    case CONST_TIMESTAMP: {
-      ++p;
-      Timestamp v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_TIMESTAMP>(v));
-      break;
+    (*op)(stack);
+    v = stack.Get();
+  } catch (...) {
+    // Leave it to be thrown at running time.
+    return nullptr;
+  }
+  auto type = op->GetType();
+  if (v == nullptr) {
+    return OP_NULL[type];
+  }
+  return MakeConstOperator(type, v, m_arena);
+}
+
+void OperatorVector::Optimize() {
+  // The index of the first operator in `vector` of each operand on the stack, and whether it is a constant.
+  struct Entry {
+    size_t start;
+    bool is_const;
+  };
+  std::vector<const Operator *> vector;
+  std::vector<Entry> stack;
+  for (const auto *op : m_vector) {
+    size_t arity = op->GetArity();
+    if (arity == 0) {
+      stack.push_back({vector.size(), op->IsConst()});
+      vector.push_back(op);
+      continue;
     }
-    case CONST_N_INT32: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_INT32>(-v));
-      break;
+    auto first = stack.end() - arity;
+    auto start = first->start;
+    if (std::all_of(first, stack.end(), [](const Entry &e) { return e.is_const; })) {
+      const auto *folded = Fold(vector.cbegin() + start, vector.cend(), op);
+      if (folded != nullptr) {
+        vector.resize(start);
+        stack.erase(first, stack.end());
+        stack.push_back({vector.size(), true});
+        vector.push_back(folded);
+        continue;
+      }
     }
-    case CONST_N_INT64: {
-      ++p;
-      int64_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new ConstOperator<TYPE_INT64>(-v));
-      break;
+    // The last operator is the one pushing the operand on top of the stack.
+    if (op == OP_NOT && vector.back() == OP_NOT) {
+      vector.pop_back();
+      continue;
     }
-    case CONST_N_BOOL:
-      ++p;
-      Add(OP_CONST_FALSE);
-      break;
-    case VAR_I_INT32: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_INT32>(v));
-      break;
+    if (op == OP_AND || op == OP_OR) {
+      // `TRUE` for `AND` and `FALSE` for `OR`, which can be removed from the operands.
+      bool identity = (op == OP_AND);
+      auto e0 = stack[stack.size() - 2];
+      auto e1 = stack[stack.size() - 1];
+      if (e1.is_const && IsConstBool(vector[e1.start], identity)) {
+        vector.erase(vector.begin() + e1.start);
+        stack.pop_back();
+        continue;
+      }
+      if (e0.is_const && IsConstBool(vector[e0.start], identity)) {
+        vector.erase(vector.begin() + e0.start);
+        stack.pop_back();
+        stack.back().is_const = e1.is_const;
+        continue;
+      }
     }
-    case VAR_I_INT64: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_INT64>(v));
-      break;
+    stack.erase(first, stack.end());
+    stack.push_back({start, false});
+    vector.push_back(op);
+  }
+  m_vector.swap(vector);
+}
+
+void OperatorVector::FuseVarConsts() {
+  std::vector<const Operator *> vector;
+  for (const auto *op : m_vector) {
+    auto size = vector.size();
+    // The two leaves right before a binary operator must be its operands.
+    if (op->GetArity() == 2 && size >= 2 && vector[size - 2]->GetArity() == 0 && vector[size - 1]->GetArity() == 0) {
+      const auto *fused = op->FuseVarConst(vector[size - 2], vector[size - 1], m_arena);
+      if (fused != nullptr) {
+        vector.resize(size - 2);
+        vector.push_back(fused);
+        continue;
+      }
     }
-    case VAR_I_BOOL: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_BOOL>(v));
-      break;
+    vector.push_back(op);
+  }
+  m_vector.swap(vector);
+}
+
+void OperatorVector::EliminateCommonSubexpressions() {
+  // Each operator is the root of the sub-expression ending at it, find where they start and the hash codes.
+  auto size = m_vector.size();
+  std::vector<size_t> starts(size);
+  std::vector<size_t> hashes(size);
+  std::vector<size_t> stack;
+  for (size_t i = 0; i < size; ++i) {
+    const auto *op = m_vector[i];
+    size_t arity = op->GetArity();
+    size_t hash = op->Hash();
+    starts[i] = (arity > 0 ? starts[stack[stack.size() - arity]] : i);
+    for (size_t k = stack.size() - arity; k < stack.size(); ++k) {
+      hash = hash * 31 + hashes[stack[k]];
     }
-    case VAR_I_FLOAT: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_FLOAT>(v));
-      break;
+    hashes[i] = hash;
+    stack.resize(stack.size() - arity);
+    stack.push_back(i);
+  }
+  auto same = [this, &starts](size_t r0, size_t r1) {
+    if (r0 - starts[r0] != r1 - starts[r1]) {
+      return false;
     }
-    case VAR_I_DOUBLE: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_DOUBLE>(v));
-      break;
+    for (size_t i = starts[r0], j = starts[r1]; i <= r0; ++i, ++j) {
+      if (!m_vector[i]->IsSame(m_vector[j])) {
+        return false;
+      }
     }
-    case VAR_I_DECIMAL: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_DECIMAL>(v));
-      break;
+    return true;
+  };
+  // Group the same sub-expressions, variables and constants are not worth saving, but fused operators are.
+  std::unordered_map<size_t, std::vector<std::vector<size_t>>> buckets;
+  for (size_t i = 0; i < size; ++i) {
+    const auto *op = m_vector[i];
+    if (op->GetArity() == 0 && (op->IsConst() || op->GetVarIndex() >= 0)) {
+      continue;
     }
-    case VAR_I_STRING: {
-      ++p;
-      int32_t v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_STRING>(v));
-      break;
+    auto &groups = buckets[hashes[i]];
+    auto it = std::find_if(groups.begin(), groups.end(), [&](const std::vector<size_t> &g) { return same(g[0], i); });
+    if (it != groups.end()) {
+      it->push_back(i);
+    } else {
+      groups.push_back({i});
     }
-    case VAR_I_DATE: {
-      ++p;
-      Date v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_DATE>(v));
-      break;
+  }
+  std::vector<std::vector<size_t>> groups;
+  for (auto &bucket : buckets) {
+    for (auto &g : bucket.second) {
+      if (g.size() > 1) {
+        groups.push_back(std::move(g));
+      }
     }
-    case VAR_I_TIMESTAMP: {
-      ++p;
-      Timestamp v;
-      p = DecodeValue(v, p);
-      AddRelease(new IndexedVarOperator<TYPE_TIMESTAMP>(v));
-      break;
+  }
+  if (groups.empty()) {
+    return;
+  }
+  // Larger ones first, so the ones inside them are counted only if still there after replacing.
+  std::sort(groups.begin(), groups.end(), [&starts](const std::vector<size_t> &g0, const std::vector<size_t> &g1) {
+    auto size0 = g0[0] - starts[g0[0]];
+    auto size1 = g1[0] - starts[g1[0]];
+    return size0 != size1 ? size0 > size1 : g0[0] < g1[0];
+  });
+  std::vector<bool> removed(size, false);
+  std::vector<const Operator *> stores(size, nullptr);
+  std::vector<const Operator *> loads(size, nullptr);
+  // The end of the sub-expressions replaced by loads, indexed by the start.
+  std::vector<size_t> ends(size);
+  for (const auto &g : groups) {
+    std::vector<size_t> roots;
+    std::copy_if(g.begin(), g.end(), std::back_inserter(roots), [&removed](size_t r) { return !removed[r]; });
+    if (roots.size() < 2) {
+      continue;
     }
-    case POS:
-      ++p;
-      successful = AddOperatorByType(OP_POS, *p);
-      ++p;
-      break;
-    case NEG:
-      ++p;
-      successful = AddOperatorByType(OP_NEG, *p);
-      ++p;
-      break;
-    case ADD:
-      ++p;
-      successful = AddOperatorByType(OP_ADD, *p);
-      ++p;
-      break;
-    case SUB:
-      ++p;
-      successful = AddOperatorByType(OP_SUB, *p);
-      ++p;
-      break;
-    case MUL:
-      ++p;
-      successful = AddOperatorByType(OP_MUL, *p);
-      ++p;
-      break;
-    case DIV:
-      ++p;
-      successful = AddOperatorByType(OP_DIV, *p);
-      ++p;
-      break;
-    case MOD:
-      ++p;
-      successful = AddOperatorByType(OP_MOD, *p);
-      ++p;
-      break;
-    case EQ:
-      ++p;
-      successful = AddOperatorByType(OP_EQ, *p);
-      ++p;
-      break;
-    case GE:
-      ++p;
-      successful = AddOperatorByType(OP_GE, *p);
-      ++p;
-      break;
-    case GT:
-      ++p;
-      successful = AddOperatorByType(OP_GT, *p);
-      ++p;
-      break;
-    case LE:
-      ++p;
-      successful = AddOperatorByType(OP_LE, *p);
-      ++p;
-      break;
-    case LT:
-      ++p;
-      successful = AddOperatorByType(OP_LT, *p);
-      ++p;
-      break;
-    case NE:
-      ++p;
-      successful = AddOperatorByType(OP_NE, *p);
-      ++p;
-      break;
-    case IS_NULL:
-      ++p;
-      successful = AddOperatorByType(OP_IS_NULL, *p);
-      ++p;
-      break;
-    case IS_TRUE:
-      ++p;
-      successful = AddOperatorByType(OP_IS_TRUE, *p);
-      ++p;
-      break;
-    case IS_FALSE:
-      ++p;
-      successful = AddOperatorByType(OP_IS_FALSE, *p);
-      ++p;
-      break;
-    case MIN:
-      ++p;
-      successful = AddOperatorByType(OP_MIN, *p);
-      ++p;
-      break;
-    case MAX:
-      ++p;
-      successful = AddOperatorByType(OP_MAX, *p);
-      ++p;
-      break;
-    case ABS:
-      ++p;
-      successful = AddOperatorByType(OP_ABS, *p);
-      ++p;
-      break;
-    case ABS_C:
-      ++p;
-      successful = AddOperatorByType(OP_ABS_CHECK, *p);
-      ++p;
-      break;
-    case NOT:
-      Add(OP_NOT);
-      ++p;
-      break;
-    case AND:
-      Add(OP_AND);
-      ++p;
-      break;
-    case OR:
-      Add(OP_OR);
-      ++p;
-      break;
-    case CAST:
-      ++p;
-      successful = AddCastOperator(OP_CAST, *p);
-      ++p;
-      break;
-    case CAST_C:
-      ++p;
-      successful = AddCastOperator(OP_CAST_CHECK, *p);
-      ++p;
-      break;
-    case FUN:
-      ++p;
-      successful = AddFunOperator(*p);
-      ++p;
-      break;
-    case EOE:
-      ++p;
-      goto eoe;
-    default:
-      successful = false;
-      break;
+    auto type = m_vector[roots[0]]->GetType();
+    auto index = static_cast<int32_t>(m_temp_num++);
+    const auto *store = m_arena.New<StoreTempOperator>(type, index);
+    const auto *load = m_arena.New<LoadTempOperator>(type, index);
+    stores[roots[0]] = store;
+    for (size_t k = 1; k < roots.size(); ++k) {
+      auto start = starts[roots[k]];
+      loads[start] = load;
+      ends[start] = roots[k];
+      std::fill(removed.begin() + start, removed.begin() + roots[k] + 1, true);
     }
   }
-eoe:
-  if (successful) {
-    return p;
+  std::vector<const Operator *> vector;
+  for (size_t i = 0; i < size; ++i) {
+    if (loads[i] != nullptr) {
+      vector.push_back(loads[i]);
+      i = ends[i];
+      continue;
+    }
+    vector.push_back(m_vector[i]);
+    if (stores[i] != nullptr) {
+      vector.push_back(stores[i]);
+    }
+  }
+  m_vector.swap(vector);
+}
+
+void OperatorVector::AddShortCircuits() {
+  auto size = m_vector.size();
+  std::vector<size_t> starts(size);
+  std::vector<std::vector<size_t>> children(size);
+  std::unordered_map<int32_t, std::vector<size_t>> loads;
+  std::vector<size_t> stack;
+  bool found = false;
+  for (size_t i = 0; i < size; ++i) {
+    const auto *op = m_vector[i];
+    size_t arity = op->GetArity();
+    starts[i] = (arity > 0 ? starts[stack[stack.size() - arity]] : i);
+    children[i].assign(stack.end() - arity, stack.end());
+    stack.resize(stack.size() - arity);
+    stack.push_back(i);
+    if (const auto *load = dynamic_cast<const LoadTempOperator *>(op); load != nullptr) {
+      loads[load->GetIndex()].push_back(i);
+    }
+    found = found || op == OP_AND || op == OP_OR || IsVariadicLogic(op);
+  }
+  if (!found) {
+    return;
+  }
+  // A range cannot be skipped if any temporary slot saved in it is loaded outside.
+  auto skippable = [this, &loads](size_t first, size_t last) {
+    for (size_t i = first; i <= last; ++i) {
+      const auto *store = dynamic_cast<const StoreTempOperator *>(m_vector[i]);
+      if (store == nullptr) {
+        continue;
+      }
+      for (auto pos : loads[store->GetIndex()]) {
+        if (pos < first || pos > last) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  std::vector<const Operator *> vector;
+  std::function<void(size_t)> emit = [&](size_t root) {
+    const auto *op = m_vector[root];
+    const auto &c = children[root];
+    if (IsVariadicLogic(op)) {
+      bool value = (dynamic_cast<const VariadicLogicOperator<true> *>(op) != nullptr);
+      // Jump after each operand but the last, unless the following operands are a single operator.
+      std::vector<std::pair<size_t, int>> jumps;
+      for (size_t k = 0; k < c.size(); ++k) {
+        emit(c[k]);
+        if (k + 1 < c.size() && c.back() > starts[c[k + 1]] && skippable(starts[c[k + 1]], c.back())) {
+          jumps.emplace_back(vector.size(), static_cast<int>(k));
+          vector.push_back(nullptr);
+        }
+      }
+      if (jumps.empty()) {
+        vector.push_back(op);
+        return;
+      }
+      auto arity = static_cast<int>(c.size());
+      auto selections = static_cast<int>(jumps.size());
+      if (value) {
+        vector.push_back(m_arena.New<VariadicLogicOperator<true>>(arity, selections));
+      } else {
+        vector.push_back(m_arena.New<VariadicLogicOperator<false>>(arity, selections));
+      }
+      for (size_t j = 0; j < jumps.size(); ++j) {
+        auto [pos, k] = jumps[j];
+        auto skip = vector.size() - pos - 1;
+        if (value) {
+          vector[pos] = m_arena.New<VariadicJumpIfOperator<true>>(skip, k, static_cast<int>(j));
+        } else {
+          vector[pos] = m_arena.New<VariadicJumpIfOperator<false>>(skip, k, static_cast<int>(j));
+        }
+      }
+      return;
+    }
+    // Jumping over a single operator is not worth it.
+    if ((op == OP_AND || op == OP_OR) && c[1] > starts[c[1]] && skippable(starts[c[1]], c[1])) {
+      emit(c[0]);
+      auto pos = vector.size();
+      vector.push_back(nullptr);
+      emit(c[1]);
+      vector.push_back(op == OP_AND ? OP_AND_SC : OP_OR_SC);
+      auto skip = vector.size() - pos - 1;
+      const Operator *jump = nullptr;
+      if (op == OP_AND) {
+        jump = m_arena.New<JumpIfOperator<false>>(skip);
+      } else {
+        jump = m_arena.New<JumpIfOperator<true>>(skip);
+      }
+      vector[pos] = jump;
+      return;
+    }
+    for (auto child : c) {
+      emit(child);
+    }
+    vector.push_back(op);
+  };
+  for (auto root : stack) {
+    emit(root);
   }
-  throw UnknownCode(b, len - (b - code));
+  m_vector.swap(vector);
 }
 
 bool OperatorVector::AddOperatorByType(const Operator *const ops[], Byte type) {
+  if (type >= TYPE_NUM) {
+    return false;
+  }
   const auto *op = ops[type];
   if (op != nullptr) {
     Add(op);
@@ -433,6 +711,9 @@ bool OperatorVector::AddOperatorByType(const Operator *const ops[], Byte type) {
 bool OperatorVector::AddCastOperator(const Operator *const ops[][TYPE_NUM], Byte b) {
   Byte dst = (Byte)(b >> 4);
   Byte src = (Byte)(b & 0x0F);
+  if (dst >= TYPE_NUM || src >= TYPE_NUM) {
+    return false;
+  }
   if (dst == src) {
     return true;
   }
@@ -18,23 +18,62 @@
 #include <vector>
 
 #include "operator.h"
+#include "operator_arena.h"
 
 namespace dingodb::expr {
 
 class OperatorVector {
  public:
-  OperatorVector() = default;
+  OperatorVector() : m_max_depth(0), m_result_num(0), m_temp_num(0) {
+  }
 
   virtual ~OperatorVector() {
     Release();
   }
 
+  /**
+   * @brief Decode an expression, which ends at `EOE` or the end of the code.
+   *
+   * The operators are dispatched by the code byte through a table, and allocated in the arena of this vector, which
+   * is reused by decoding again. Reading beyond `len` throws `UnknownCode`, and an expression not well-typed throws
+   * `ExprError` by verifying.
+   *
+   * @return the end of the bytes used
+   */
   const Byte *Decode(const Byte code[], size_t len);
 
   Byte GetType() const {
     return m_vector.back()->GetType();
   }
 
+  /**
+   * @brief Get the maximum depth of the operand stack while running, which is known after decoding.
+   */
+  size_t GetMaxDepth() const {
+    return m_max_depth;
+  }
+
+  /**
+   * @brief Get the number of operands left in the stack after running.
+   */
+  size_t GetResultNum() const {
+    return m_result_num;
+  }
+
+  /**
+   * @brief Get the types of the variables indexed by the index in tuples, `TYPE_NULL` for the ones not got as values.
+   */
+  const std::vector<Byte> &GetVarTypes() const {
+    return m_var_types;
+  }
+
+  /**
+   * @brief Get the number of temporary slots to save common sub-expressions.
+   */
+  size_t GetTempNum() const {
+    return m_temp_num;
+  }
+
   auto begin() const  // NOLINT(readability-identifier-naming)
   {
     return m_vector.cbegin();
@@ -46,24 +85,31 @@ class OperatorVector {
   }
 
  private:
+  /**
+   * @brief Decode the operands of an operator from the byte after its code, and add the operator.
+   *
+   * @return the end of the bytes used, or `nullptr` if the code is invalid
+   */
+  using DecodeFun = const Byte *(*)(OperatorVector &vector, const Byte *p, const Byte *end);
+
+  struct DecodeTable;
+
   std::vector<const Operator *> m_vector;
-  std::vector<const Operator *> m_to_release;
+  std::vector<Byte> m_var_types;
+  OperatorArena m_arena;
+  size_t m_max_depth;
+  size_t m_result_num;
+  size_t m_temp_num;
 
   void Add(const Operator *op) {
     m_vector.push_back(op);
   }
 
-  void AddRelease(const Operator *op) {
-    m_vector.push_back(op);
-    m_to_release.push_back(op);
-  }
-
   void Release() {
-    for (const auto *op : m_to_release) {
-      delete op;
-    }
-    m_to_release.clear();
     m_vector.clear();
+    m_var_types.clear();
+    m_arena.Clear();
+    m_temp_num = 0;
   }
 
   /**
@@ -87,6 +133,55 @@ class OperatorVector {
   [[nodiscard]] bool AddCastOperator(const Operator *const ops[][TYPE_NUM], Byte b);
 
   [[nodiscard]] bool AddFunOperator(Byte b);
+
+  void CalcMaxDepth();
+
+  /**
+   * @brief Check the number and the types of the operands of each operator, and collect the types of the variables.
+   *
+   * Null constants are of any type, and the variables are of the types only if they are got as values by operators.
+   *
+   * The stack depth is calculated as well, as `CalcMaxDepth` does.
+   */
+  void Verify();
+
+  void AddVarType(int32_t index, Byte type);
+
+  /**
+   * @brief Fold constant sub-expressions and simplify `x AND TRUE`, `x OR FALSE` and `NOT NOT x`.
+   */
+  void Optimize();
+
+  /**
+   * @brief Fuse binary operators with their operands if they are a variable and a constant, e.g. `t0 > 5`.
+   */
+  void FuseVarConsts();
+
+  /**
+   * @brief Evaluate each repeated sub-expression only once, save it to a temporary slot and load it later.
+   */
+  void EliminateCommonSubexpressions();
+
+  /**
+   * @brief Insert jumps before the right operands of `AND` and `OR`, to skip them if the left ones decide the result.
+   *
+   * For variadic `AND` and `OR`, a jump is inserted after each operand to skip all the following ones.
+   */
+  void AddShortCircuits();
+
+  /**
+   * @brief Evaluate an operator whose operands are all constants, to a new constant operator.
+   *
+   * @param first the first of the constant operators
+   * @param last the end of the constant operators
+   * @param op the operator
+   * @return const Operator* the constant operator, or `nullptr` if it cannot be folded
+   */
+  const Operator *Fold(
+      std::vector<const Operator *>::const_iterator first,
+      std::vector<const Operator *>::const_iterator last,
+      const Operator *op
+  );
 };
 
 }  // namespace dingodb::expr
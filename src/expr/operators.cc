@@ -407,6 +407,44 @@ const Operator *const OP_MAX[] = {
     [TYPE_STRING]  = new BinaryArithmeticOperator<TYPE_STRING, calc::Max>,
 };
 
+template <typename Op>
+static const Operator *MakeVariadic(int arity, OperatorArena &arena) {
+  return arena.New<Op>(arity);
+}
+
+const VariadicMaker MAKE_SUM[] = {
+    [TYPE_NULL]    = nullptr,
+    [TYPE_INT32]   = MakeVariadic<VariadicOperator<TYPE_INT32, calc::Add>>,
+    [TYPE_INT64]   = MakeVariadic<VariadicOperator<TYPE_INT64, calc::Add>>,
+    [TYPE_BOOL]    = nullptr,
+    [TYPE_FLOAT]   = MakeVariadic<VariadicOperator<TYPE_FLOAT, calc::Add>>,
+    [TYPE_DOUBLE]  = MakeVariadic<VariadicOperator<TYPE_DOUBLE, calc::Add>>,
+    [TYPE_DECIMAL] = MakeVariadic<VariadicOperator<TYPE_DECIMAL, calc::Add>>,
+    [TYPE_STRING]  = nullptr,
+};
+
+const VariadicMaker MAKE_VARG_MIN[] = {
+    [TYPE_NULL]    = nullptr,
+    [TYPE_INT32]   = MakeVariadic<VariadicOperator<TYPE_INT32, calc::Min>>,
+    [TYPE_INT64]   = MakeVariadic<VariadicOperator<TYPE_INT64, calc::Min>>,
+    [TYPE_BOOL]    = MakeVariadic<VariadicOperator<TYPE_BOOL, calc::Min>>,
+    [TYPE_FLOAT]   = MakeVariadic<VariadicOperator<TYPE_FLOAT, calc::Min>>,
+    [TYPE_DOUBLE]  = MakeVariadic<VariadicOperator<TYPE_DOUBLE, calc::Min>>,
+    [TYPE_DECIMAL] = MakeVariadic<VariadicOperator<TYPE_DECIMAL, calc::Min>>,
+    [TYPE_STRING]  = MakeVariadic<VariadicOperator<TYPE_STRING, calc::Min>>,
+};
+
+const VariadicMaker MAKE_VARG_MAX[] = {
+    [TYPE_NULL]    = nullptr,
+    [TYPE_INT32]   = MakeVariadic<VariadicOperator<TYPE_INT32, calc::Max>>,
+    [TYPE_INT64]   = MakeVariadic<VariadicOperator<TYPE_INT64, calc::Max>>,
+    [TYPE_BOOL]    = MakeVariadic<VariadicOperator<TYPE_BOOL, calc::Max>>,
+    [TYPE_FLOAT]   = MakeVariadic<VariadicOperator<TYPE_FLOAT, calc::Max>>,
+    [TYPE_DOUBLE]  = MakeVariadic<VariadicOperator<TYPE_DOUBLE, calc::Max>>,
+    [TYPE_DECIMAL] = MakeVariadic<VariadicOperator<TYPE_DECIMAL, calc::Max>>,
+    [TYPE_STRING]  = MakeVariadic<VariadicOperator<TYPE_STRING, calc::Max>>,
+};
+
 const Operator *const OP_ABS[] = {
     [TYPE_NULL]    = nullptr,
     [TYPE_INT32]   = new UnaryArithmeticOperator<TYPE_INT32, calc::Abs>,
@@ -432,6 +470,16 @@ const Operator *const OP_ABS_CHECK[] = {
 const Operator *const OP_NOT = new NotOperator();
 const Operator *const OP_AND = new AndOperator();
 const Operator *const OP_OR  = new OrOperator();
+const Operator *const OP_AND_SC = new ShortCircuitAndOperator();
+const Operator *const OP_OR_SC  = new ShortCircuitOrOperator();
+
+const Operator *MakeAndFun(int arity, OperatorArena &arena) {
+  return arena.New<VariadicLogicOperator<false>>(arity);
+}
+
+const Operator *MakeOrFun(int arity, OperatorArena &arena) {
+  return arena.New<VariadicLogicOperator<true>>(arity);
+}
 
 const size_t FUN_NUM = 0x36;
 
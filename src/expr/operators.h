@@ -51,9 +51,23 @@ extern const Operator *const OP_MIN[TYPE_NUM];
 extern const Operator *const OP_ABS[TYPE_NUM];
 extern const Operator *const OP_ABS_CHECK[TYPE_NUM];
 
+/**
+ * @brief Make an operator of many operands in an arena, for the operators of which the arity is decoded.
+ */
+using VariadicMaker = const Operator *(*)(int arity, OperatorArena &arena);
+
+extern const VariadicMaker MAKE_SUM[TYPE_NUM];
+extern const VariadicMaker MAKE_VARG_MIN[TYPE_NUM];
+extern const VariadicMaker MAKE_VARG_MAX[TYPE_NUM];
+
+const Operator *MakeAndFun(int arity, OperatorArena &arena);
+const Operator *MakeOrFun(int arity, OperatorArena &arena);
+
 extern const Operator *const OP_NOT;
 extern const Operator *const OP_AND;
 extern const Operator *const OP_OR;
+extern const Operator *const OP_AND_SC;
+extern const Operator *const OP_OR_SC;
 
 extern const size_t FUN_NUM;
 extern const Operator *const OP_FUN[];
@@ -0,0 +1,135 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "program.h"
+
+#include "exception.h"
+#include "execution_context.h"
+
+namespace dingodb::expr {
+
+// Check if the operand is null or of the type, any one for `TYPE_NULL`.
+static bool IsOfType(const Operand &v, Byte type) {
+  switch (type) {
+  case TYPE_INT32:
+    return v == nullptr || v.Is<TypeOf<TYPE_INT32>>();
+  case TYPE_INT64:
+  case TYPE_DATE:
+  case TYPE_TIMESTAMP:
+    return v == nullptr || v.Is<TypeOf<TYPE_INT64>>();
+  case TYPE_BOOL:
+    return v == nullptr || v.Is<TypeOf<TYPE_BOOL>>();
+  case TYPE_FLOAT:
+    return v == nullptr || v.Is<TypeOf<TYPE_FLOAT>>();
+  case TYPE_DOUBLE:
+    return v == nullptr || v.Is<TypeOf<TYPE_DOUBLE>>();
+  case TYPE_DECIMAL:
+    return v == nullptr || v.Is<TypeOf<TYPE_DECIMAL>>();
+  case TYPE_STRING:
+    return v == nullptr || v.Is<TypeOf<TYPE_STRING>>();
+  default:
+    return true;
+  }
+}
+
+// Dates and timestamps are stored as `int64_t`.
+static Byte StorageOf(Byte type) {
+  return (type == TYPE_DATE || type == TYPE_TIMESTAMP) ? TYPE_INT64 : type;
+}
+
+void Program::Run(ExecutionContext &context) const {
+  auto &stack = context.GetOperandStack();
+  // Once for each run, instead of checking each operand while running.
+  CheckTuple(stack.GetTuple());
+  // Nothing to do if the context is prepared for this program.
+  stack.Reserve(GetMaxDepth());
+  stack.ReserveTemps(GetTempNum());
+  stack.Clear();
+  auto end = m_operator_vector.end();
+  for (auto it = m_operator_vector.begin(); it < end; it += 1 + stack.TakeSkip()) {
+    (**it)(stack);
+  }
+}
+
+void Program::RunBatch(ExecutionContext &context, const Batch *batch,
+                       const std::shared_ptr<uint64_t[]> &selection) const {
+  auto error = TryRunBatch(context, batch, selection);
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+std::exception_ptr Program::TryRunBatch(ExecutionContext &context, const Batch *batch,
+                                        const std::shared_ptr<uint64_t[]> &selection) const {
+  auto &stack = context.GetColumnStack();
+  stack.ReserveTemps(GetTempNum());
+  stack.BindBatch(batch);
+  stack.Clear();
+  if (selection != nullptr) {
+    stack.PushSelection(selection);
+  }
+  auto end = m_operator_vector.end();
+  try {
+    CheckBatch(batch);
+    for (auto it = m_operator_vector.begin(); it < end && !stack.HasError(); it += 1 + stack.TakeSkip()) {
+      (**it)(stack);
+    }
+  } catch (...) {
+    stack.SetError(std::current_exception());
+  }
+  return stack.GetError();
+}
+
+void Program::CheckTuple(const Tuple *tuple) const {
+  const auto &types = m_operator_vector.GetVarTypes();
+  if (types.empty()) {
+    return;
+  }
+  if (tuple == nullptr) {
+    throw ExprError("No tuple provided.");
+  }
+  if (tuple->size() < types.size()) {
+    throw ExprError(
+        "Tuple of " + std::to_string(tuple->size()) + " elements, but " + std::to_string(types.size()) + " required."
+    );
+  }
+  for (size_t i = 0; i < types.size(); ++i) {
+    if (!IsOfType((*tuple)[i], types[i])) {
+      throw ExprError("Element " + std::to_string(i) + " of tuple is not of type " + TypeName(types[i]) + ".");
+    }
+  }
+}
+
+void Program::CheckBatch(const Batch *batch) const {
+  const auto &types = m_operator_vector.GetVarTypes();
+  if (types.empty()) {
+    return;
+  }
+  if (batch == nullptr) {
+    throw ExprError("No batch provided.");
+  }
+  if (batch->ColumnNum() < types.size()) {
+    throw ExprError(
+        "Batch of " + std::to_string(batch->ColumnNum()) + " columns, but " + std::to_string(types.size()) +
+        " required."
+    );
+  }
+  for (size_t i = 0; i < types.size(); ++i) {
+    if (types[i] != TYPE_NULL && StorageOf((*batch)[i].GetType()) != StorageOf(types[i])) {
+      throw ExprError("Column " + std::to_string(i) + " of batch is not of type " + TypeName(types[i]) + ".");
+    }
+  }
+}
+
+}  // namespace dingodb::expr
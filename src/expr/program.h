@@ -0,0 +1,109 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_PROGRAM_H_
+#define _EXPR_PROGRAM_H_
+
+#include <exception>
+
+#include "batch.h"
+#include "operator_vector.h"
+#include "types.h"
+
+namespace dingodb::expr {
+
+class ExecutionContext;
+
+/**
+ * @brief A decoded expression, which is immutable after decoding and can be run by many threads at the same time.
+ *
+ * All the states of evaluating are kept in an `ExecutionContext`, one for each thread.
+ */
+class Program {
+ public:
+  Program() = default;
+
+  virtual ~Program() = default;
+
+  Program(const Program &) = delete;
+
+  Program &operator=(const Program &) = delete;
+
+  const Byte *Decode(const Byte *code, size_t len) {
+    return m_operator_vector.Decode(code, len);
+  }
+
+  void Run(ExecutionContext &context) const;
+
+  /**
+   * @brief Evaluate over all rows of a batch at once.
+   *
+   * @param context the context to keep the result columns
+   * @param batch the input batch, which must be alive until the results are got
+   * @param selection the bitmap of the rows to evaluate, `nullptr` for all rows; the results of other rows are undefined
+   */
+  void RunBatch(ExecutionContext &context, const Batch *batch,
+                const std::shared_ptr<uint64_t[]> &selection = nullptr) const;
+
+  /**
+   * @brief The same as `RunBatch`, but the error is returned instead of thrown.
+   *
+   * @return the error, or `nullptr` if succeeded
+   */
+  std::exception_ptr TryRunBatch(ExecutionContext &context, const Batch *batch,
+                                 const std::shared_ptr<uint64_t[]> &selection = nullptr) const;
+
+  Byte GetType() const {
+    return m_operator_vector.GetType();
+  }
+
+  size_t GetMaxDepth() const {
+    return m_operator_vector.GetMaxDepth();
+  }
+
+  size_t GetResultNum() const {
+    return m_operator_vector.GetResultNum();
+  }
+
+  size_t GetTempNum() const {
+    return m_operator_vector.GetTempNum();
+  }
+
+  /**
+   * @brief Check that the tuple has all the variables of the types verified, so they are read without checking.
+   */
+  void CheckTuple(const Tuple *tuple) const;
+
+  /**
+   * @brief Check that the batch has all the variables, with the columns of the types verified.
+   */
+  void CheckBatch(const Batch *batch) const;
+
+  auto begin() const  // NOLINT(readability-identifier-naming)
+  {
+    return m_operator_vector.begin();
+  }
+
+  auto end() const  // NOLINT(readability-identifier-naming)
+  {
+    return m_operator_vector.end();
+  }
+
+ private:
+  OperatorVector m_operator_vector;
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_PROGRAM_H_ */
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "program_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace dingodb::expr {
+
+ProgramCache::ProgramCache(size_t capacity, size_t shard_num)
+    : m_shard_capacity(std::max<size_t>(1, capacity / std::max<size_t>(1, shard_num))),
+      m_shards(std::max<size_t>(1, shard_num)),
+      m_hits(0),
+      m_misses(0) {
+}
+
+ProgramCache &ProgramCache::Instance() {
+  static ProgramCache cache(DEFAULT_CAPACITY);
+  return cache;
+}
+
+const Byte *ProgramCache::Decode(std::shared_ptr<const Program> &program, const Byte *code, size_t len) {
+  std::string_view key(reinterpret_cast<const char *>(code), len);
+  auto &shard = m_shards[std::hash<std::string_view>()(key) % m_shards.size()];
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      program = it->second->program;
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return code + it->second->consumed;
+    }
+  }
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  // Decode without holding the lock, another thread may decode the same bytes concurrently, which is harmless.
+  auto decoded = std::make_shared<Program>();
+  const auto *end = decoded->Decode(code, len);
+  program = decoded;
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.map.find(key) == shard.map.end()) {
+    shard.lru.push_front(Entry{std::string(key), program, static_cast<size_t>(end - code)});
+    shard.map.emplace(shard.lru.front().key, shard.lru.begin());
+    if (shard.lru.size() > m_shard_capacity) {
+      shard.map.erase(shard.lru.back().key);
+      shard.lru.pop_back();
+    }
+  }
+  return end;
+}
+
+void ProgramCache::Clear() {
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.map.clear();
+    shard.lru.clear();
+  }
+}
+
+size_t ProgramCache::Size() const {
+  size_t size = 0;
+  for (const auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.lru.size();
+  }
+  return size;
+}
+
+}  // namespace dingodb::expr
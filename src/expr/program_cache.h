@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_PROGRAM_CACHE_H_
+#define _EXPR_PROGRAM_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "program.h"
+#include "types.h"
+
+namespace dingodb::expr {
+
+/**
+ * @brief A thread-safe LRU cache of decoded programs, keyed by the bytes to decode.
+ *
+ * The decoded `Program`s are immutable and shared by all the runners decoding the same bytes. The cache is split
+ * into shards by the hash of the key, each of which has its own lock and LRU list.
+ */
+class ProgramCache {
+ public:
+  static const size_t DEFAULT_CAPACITY = 1024;
+  static const size_t DEFAULT_SHARD_NUM = 16;
+
+  ProgramCache(size_t capacity, size_t shard_num = DEFAULT_SHARD_NUM);
+
+  virtual ~ProgramCache() = default;
+
+  /**
+   * @brief Get the process-wide cache used by `Runner`.
+   */
+  static ProgramCache &Instance();
+
+  /**
+   * @brief Get the decoded program of the bytes, decode and cache it if not cached.
+   *
+   * @param program the decoded program
+   * @param code the bytes to decode
+   * @param len the length of the bytes
+   * @return const Byte* the position after the decoded bytes, just as `Program::Decode`
+   */
+  const Byte *Decode(std::shared_ptr<const Program> &program, const Byte *code, size_t len);
+
+  void Clear();
+
+  size_t Size() const;
+
+  uint64_t GetHits() const {
+    return m_hits.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetMisses() const {
+    return m_misses.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const Program> program;
+    size_t consumed;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used at front.
+    std::list<Entry> lru;
+    // The keys are views of the keys in `lru`.
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> map;
+  };
+
+  size_t m_shard_capacity;
+  std::vector<Shard> m_shards;
+  std::atomic<uint64_t> m_hits;
+  std::atomic<uint64_t> m_misses;
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_PROGRAM_CACHE_H_ */
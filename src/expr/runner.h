@@ -15,51 +15,102 @@
 #ifndef _EXPR_RUNNER_H_
 #define _EXPR_RUNNER_H_
 
-#include "operand_stack.h"
-#include "operator_vector.h"
+#include <memory>
+
+#include "batch.h"
+#include "execution_context.h"
+#include "program.h"
+#include "program_cache.h"
 #include "types.h"
 
 namespace dingodb::expr {
 
+/**
+ * @brief A `Program` together with an `ExecutionContext` for convenience.
+ *
+ * The program may be shared by other runners, but the runner itself must be used by one thread at a time.
+ */
 class Runner {
  public:
   Runner() = default;
 
+  /**
+   * @brief Create a runner of a program already decoded, typically by another runner of another thread.
+   */
+  Runner(std::shared_ptr<const Program> program) : m_program(std::move(program)) {
+    m_context.Prepare(*m_program);
+  }
+
   virtual ~Runner() = default;
 
   const Byte *Decode(const Byte *code, size_t len) {
-    return m_operator_vector.Decode(code, len);
+    const auto *end = ProgramCache::Instance().Decode(m_program, code, len);
+    m_context.Prepare(*m_program);
+    return end;
   }
 
   void BindTuple(const Tuple *tuple) const {
-    m_operand_stack.BindTuple(tuple);
+    m_context.BindTuple(tuple);
   }
 
-  void Run() const;
+  void Run() const {
+    m_program->Run(m_context);
+  }
 
   Operand Get() const {
-    return m_operand_stack.Get();
+    return m_context.Get();
   }
 
   template <typename T>
   std::optional<T> GetOptional() const {
-    auto operand = Get();
-    if (operand != nullptr) {
-      return std::optional<T>(operand.GetValue<T>());
-    }
-    return std::optional<T>();
+    return m_context.GetOptional<T>();
   }
 
   Byte GetType() const {
-    return m_operator_vector.GetType();
+    return m_program->GetType();
   }
 
-  Tuple *GetAll() const;
+  Tuple *GetAll() const {
+    return m_context.GetAll();
+  }
 
- private:
-  mutable OperandStack m_operand_stack;
+  /**
+   * @brief Evaluate the expression over all rows of a batch at once.
+   *
+   * @param batch the input batch, which must be alive until the results are got
+   * @param selection the bitmap of the rows to evaluate, `nullptr` for all rows; the results of other rows are undefined
+   */
+  void RunBatch(const Batch *batch, const std::shared_ptr<uint64_t[]> &selection = nullptr) const {
+    m_program->RunBatch(m_context, batch, selection);
+  }
+
+  /**
+   * @brief The same as `RunBatch`, but the error, e.g. an overflow in any row, is returned instead of thrown.
+   *
+   * @return the error, or `nullptr` if succeeded
+   */
+  std::exception_ptr TryRunBatch(const Batch *batch, const std::shared_ptr<uint64_t[]> &selection = nullptr) const {
+    return m_program->TryRunBatch(m_context, batch, selection);
+  }
+
+  Column GetColumn() const {
+    return m_context.GetColumn();
+  }
+
+  /**
+   * @brief Get all the result columns as a batch, which must be released by the caller.
+   */
+  Batch *GetAllColumns() const {
+    return m_context.GetAllColumns();
+  }
+
+  std::shared_ptr<const Program> GetProgram() const {
+    return m_program;
+  }
 
-  OperatorVector m_operator_vector;
+ private:
+  std::shared_ptr<const Program> m_program;
+  mutable ExecutionContext m_context;
 };
 
 }  // namespace dingodb::expr
@@ -32,6 +32,10 @@ const char *TypeName(Byte type) {
     return "DECIMAL";
   case TYPE_STRING:
     return "STRING";
+  case TYPE_DATE:
+    return "DATE";
+  case TYPE_TIMESTAMP:
+    return "TIMESTAMP";
   default:
     return "UNKNOWN";
   }
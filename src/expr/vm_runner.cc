@@ -0,0 +1,58 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vm_runner.h"
+
+#include <iterator>
+
+namespace dingodb::expr {
+
+const Byte *VmRunner::Decode(const Byte *code, size_t len) {
+  const auto *end = ProgramCache::Instance().Decode(m_program, code, len);
+  Lower();
+  return end;
+}
+
+Tuple *VmRunner::GetAll() const {
+  auto *tuple = new Tuple();
+  for (size_t i = 0; i < m_result_num; ++i) {
+    tuple->push_back(m_registers[m_result_base + i].GetOperand());
+  }
+  return tuple;
+}
+
+void VmRunner::Lower() {
+  m_instructions.clear();
+  // The temporary slots are the first registers, followed by the ones of the stack.
+  size_t base = m_program->GetTempNum();
+  size_t depth = 0;
+  for (const auto *op : *m_program) {
+    size_t arity = op->GetArity();
+    Instruction inst;
+    inst.op = op;
+    // The operands of variadic operators are read from the registers following `dst`.
+    for (size_t i = 0; i < arity && i < std::size(inst.src); ++i) {
+      inst.src[i] = base + depth - arity + i;
+    }
+    inst.dst = base + depth - arity;
+    op->Lower(inst);
+    m_instructions.push_back(inst);
+    depth = depth - arity + 1;
+  }
+  m_result_base = base;
+  m_result_num = m_program->GetResultNum();
+  m_registers.assign(base + m_program->GetMaxDepth(), Slot());
+}
+
+}  // namespace dingodb::expr
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _EXPR_VM_RUNNER_H_
+#define _EXPR_VM_RUNNER_H_
+
+#include <vector>
+
+#include "instruction.h"
+#include "program_cache.h"
+#include "types.h"
+
+namespace dingodb::expr {
+
+/**
+ * @brief Evaluate expressions on a register VM, a drop-in replacement of `Runner`.
+ *
+ * The operators decoded are lowered to a flat array of instructions, which read and write typed registers directly
+ * instead of pushing and popping `Operand`s on a stack.
+ */
+class VmRunner {
+ public:
+  VmRunner() : m_result_base(0), m_result_num(0), m_tuple(nullptr) {
+  }
+
+  virtual ~VmRunner() = default;
+
+  const Byte *Decode(const Byte *code, size_t len);
+
+  void BindTuple(const Tuple *tuple) const {
+    m_tuple = tuple;
+  }
+
+  void Run() const {
+    m_program->CheckTuple(m_tuple);
+    auto *regs = m_registers.data();
+    const auto *inst = m_instructions.data();
+    const auto *end = inst + m_instructions.size();
+    while (inst < end) {
+      inst = inst->exec(*inst, regs, m_tuple);
+    }
+  }
+
+  Operand Get() const {
+    return m_registers[m_result_base + m_result_num - 1].GetOperand();
+  }
+
+  template <typename T>
+  std::optional<T> GetOptional() const {
+    auto operand = Get();
+    if (operand != nullptr) {
+      return std::optional<T>(operand.GetValue<T>());
+    }
+    return std::optional<T>();
+  }
+
+  Byte GetType() const {
+    return m_program->GetType();
+  }
+
+  Tuple *GetAll() const;
+
+ private:
+  std::shared_ptr<const Program> m_program;
+  std::vector<Instruction> m_instructions;
+  mutable std::vector<Slot> m_registers;
+  // The first register of the stack.
+  size_t m_result_base;
+  // The number of results left in registers after running, i.e. the stack depth.
+  size_t m_result_num;
+  mutable const Tuple *m_tuple;
+
+  void Lower();
+};
+
+}  // namespace dingodb::expr
+
+#endif /* _EXPR_VM_RUNNER_H_ */
@@ -16,11 +16,23 @@
 
 namespace dingodb::rel::op {
 
-expr::Operand CountAllAgg::Add(const expr::Operand &var, [[maybe_unused]] const expr::Tuple *tuple) const {
-  if (var != nullptr) {
-    return var.GetValue<int64_t>() + 1LL;
-  }
-  return 1LL;
+void CountAllAgg::Update(void *state, [[maybe_unused]] const expr::Tuple *tuple) const {
+  ++StateOf(state);
+}
+
+void CountAllAgg::UpdateRow(void *state, [[maybe_unused]] const expr::Batch *batch, [[maybe_unused]] size_t row) const {
+  ++StateOf(state);
+}
+
+void CountAllAgg::UpdateSelected(void *state, const expr::Batch *batch, const uint64_t *selection) const {
+  int64_t count = 0;
+  expr::ForEachSelected(selection, batch->Size(), [&count](size_t) { ++count; });
+  StateOf(state) += count;
+}
+
+expr::Operand CountAllAgg::Finalize(const void *state) const {
+  auto count = StateOf(state);
+  return count != 0 ? expr::Operand(count) : expr::Operand(nullptr);
 }
 
 }  // namespace dingodb::rel::op
@@ -15,21 +15,100 @@
 #ifndef _REL_OP_AGG_H_
 #define _REL_OP_AGG_H_
 
+#include <new>
+#include <type_traits>
+
+#include "../../expr/batch.h"
 #include "../../expr/calc/arithmetic.h"
 #include "../../expr/calc/mathematic.h"
 #include "../../expr/operand.h"
 
 namespace dingodb::rel::op {
 
+/**
+ * @brief An aggregation, which accumulates rows into a state kept by the operator in a fixed slot.
+ *
+ * The state is initialized by `Init` before any row is added, updated in place for each row, and turned into the
+ * result by `Finalize`. `Destroy` must be called at last.
+ */
 class Agg {
  public:
   Agg() = default;
   virtual ~Agg() = default;
 
-  virtual expr::Operand Add(const expr::Operand &var, const expr::Tuple *tuple) const = 0;
+  /**
+   * @brief Size in bytes of the state.
+   */
+  virtual size_t StateSize() const = 0;
+
+  /**
+   * @brief Alignment in bytes of the state.
+   */
+  virtual size_t StateAlign() const = 0;
+
+  virtual void Init(void *state) const = 0;
+
+  virtual void Update(void *state, const expr::Tuple *tuple) const = 0;
+
+  /**
+   * @brief The counterpart of `Update` for a row of a batch.
+   */
+  virtual void UpdateRow(void *state, const expr::Batch *batch, size_t row) const = 0;
+
+  /**
+   * @brief Update by all the rows selected of a batch.
+   *
+   * @param selection the bitmap of the rows selected, `nullptr` for all rows
+   */
+  virtual void UpdateSelected(void *state, const expr::Batch *batch, const uint64_t *selection) const {
+    expr::ForEachSelected(selection, batch->Size(), [&](size_t row) { UpdateRow(state, batch, row); });
+  }
+
+  /**
+   * @brief Get the result, `nullptr` if no row is accumulated.
+   */
+  virtual expr::Operand Finalize(const void *state) const = 0;
+
+  virtual void Destroy(void *state) const = 0;
+};
+
+/**
+ * @brief An aggregation with state of type `S`.
+ */
+template <typename S>
+class StateAgg : public Agg {
+ public:
+  StateAgg() = default;
+  ~StateAgg() override = default;
+
+  size_t StateSize() const override {
+    return sizeof(S);
+  }
+
+  size_t StateAlign() const override {
+    return alignof(S);
+  }
+
+  void Init(void *state) const override {
+    new (state) S();
+  }
+
+  void Destroy(void *state) const override {
+    static_cast<S *>(state)->~S();
+  }
+
+ protected:
+  static S &StateOf(void *state) {
+    return *static_cast<S *>(state);
+  }
+
+  static const S &StateOf(const void *state) {
+    return *static_cast<const S *>(state);
+  }
 };
 
-class UnityAgg : public Agg {
+template <typename S>
+class UnityAgg : public StateAgg<S> {
  public:
   UnityAgg(int32_t index) : m_index(index) {
   }
@@ -40,50 +119,141 @@ class UnityAgg : public Agg {
   int32_t m_index;
 };
 
-class CountAllAgg : public Agg {
+class CountAllAgg : public StateAgg<int64_t> {
  public:
   CountAllAgg() = default;
   ~CountAllAgg() override = default;
 
-  expr::Operand Add(const expr::Operand &var, const expr::Tuple *tuple) const override;
+  void Update(void *state, const expr::Tuple *tuple) const override;
+
+  void UpdateRow(void *state, const expr::Batch *batch, size_t row) const override;
+
+  void UpdateSelected(void *state, const expr::Batch *batch, const uint64_t *selection) const override;
+
+  expr::Operand Finalize(const void *state) const override;
 };
 
 template <typename T>
-class CountAgg : public UnityAgg {
+class CountAgg : public UnityAgg<int64_t> {
  public:
   CountAgg(int32_t index) : UnityAgg(index) {
   }
 
   ~CountAgg() override = default;
 
-  expr::Operand Add(const expr::Operand &var, const expr::Tuple *tuple) const override {
-    if ((*tuple)[m_index] != nullptr) {
-      if (var != nullptr) {
-        return var.GetValue<int64_t>() + 1LL;
-      }
-      return 1LL;
-    }
-    return var;
+  void Update(void *state, const expr::Tuple *tuple) const override {
+    StateOf(state) += ((*tuple)[m_index] != nullptr);
+  }
+
+  void UpdateRow(void *state, const expr::Batch *batch, size_t row) const override {
+    StateOf(state) += !(*batch)[m_index].IsNull(row);
+  }
+
+  void UpdateSelected(void *state, const expr::Batch *batch, const uint64_t *selection) const override {
+    const auto &column = (*batch)[m_index];
+    int64_t count = 0;
+    expr::ForEachSelected(selection, batch->Size(), [&](size_t row) { count += !column.IsNull(row); });
+    StateOf(state) += count;
+  }
+
+  expr::Operand Finalize(const void *state) const override {
+    auto count = StateOf(state);
+    return count != 0 ? expr::Operand(count) : expr::Operand(nullptr);
   }
 };
 
-template <typename T, T (*Calc)(T, T)>
-class CalcAgg : public UnityAgg {
+/**
+ * @brief The state of `CalcAgg`, the value accumulated and whether there is any.
+ */
+template <typename T>
+struct CalcState {
+  T value{};
+  bool has_value = false;
+};
+
+/**
+ * @brief How `CalcAgg` accumulates the values, min and max only replace the value kept.
+ */
+enum CalcAggKind {
+  CALC_AGG_FOLD,
+  CALC_AGG_MIN,
+  CALC_AGG_MAX,
+};
+
+template <typename T, T (*Calc)(T, T), CalcAggKind Kind = CALC_AGG_FOLD>
+class CalcAgg : public UnityAgg<CalcState<T>> {
  public:
-  CalcAgg(int32_t index) : UnityAgg(index) {
+  CalcAgg(int32_t index) : UnityAgg<CalcState<T>>(index) {
   }
 
   ~CalcAgg() override = default;
 
-  expr::Operand Add(const expr::Operand &var, const expr::Tuple *tuple) const override {
-    if ((*tuple)[m_index] != nullptr) {
-      auto v = ((*tuple)[m_index]).template GetValue<T>();
-      if (var != nullptr) {
-        return Calc(var.GetValue<T>(), v);
+  void Update(void *state, const expr::Tuple *tuple) const override {
+    const auto &v = (*tuple)[this->m_index];
+    if (v != nullptr) {
+      Accumulate(this->StateOf(state), v.template GetValue<T>());
+    }
+  }
+
+  void UpdateRow(void *state, const expr::Batch *batch, size_t row) const override {
+    const auto &column = (*batch)[this->m_index];
+    if (!column.IsNull(row)) {
+      Accumulate(this->StateOf(state), column.template Values<T>()[row]);
+    }
+  }
+
+  void UpdateSelected(void *state, const expr::Batch *batch, const uint64_t *selection) const override {
+    const auto &column = (*batch)[this->m_index];
+    const auto *values = column.template Values<T>();
+    auto &s = this->StateOf(state);
+    expr::ForEachSelected(selection, batch->Size(), [&](size_t row) {
+      if (!column.IsNull(row)) {
+        Accumulate(s, values[row]);
       }
+    });
+  }
+
+  expr::Operand Finalize(const void *state) const override {
+    const auto &s = this->StateOf(state);
+    return s.has_value ? expr::Operand(s.value) : expr::Operand(nullptr);
+  }
+
+ private:
+  static bool Less(const T &v0, const T &v1) {
+    if constexpr (std::is_same_v<T, expr::String>) {
+      return *v0 < *v1;
+    } else {
+      return v0 < v1;
+    }
+  }
+
+  // Strings are kept longer than the rows, so copied if the characters are owned by the caller.
+  static T Keep(const T &v) {
+    if constexpr (std::is_same_v<T, expr::String>) {
+      return v.Owned();
+    } else {
       return v;
     }
-    return var;
+  }
+
+  static void Accumulate(CalcState<T> &s, const T &v) {
+    if (!s.has_value) {
+      s.value = Keep(v);
+      s.has_value = true;
+      return;
+    }
+    // Min and max only replace the value kept if needed, not to touch the reference count of strings otherwise.
+    if constexpr (Kind == CALC_AGG_MAX) {
+      if (Less(s.value, v)) {
+        s.value = Keep(v);
+      }
+    } else if constexpr (Kind == CALC_AGG_MIN) {
+      if (Less(v, s.value)) {
+        s.value = Keep(v);
+      }
+    } else {
+      s.value = Calc(s.value, v);
+    }
   }
 };
 
@@ -91,10 +261,10 @@ template <typename T>
 using SumAgg = CalcAgg<T, expr::calc::Add>;
 
 template <typename T>
-using MinAgg = CalcAgg<T, expr::calc::Min>;
+using MinAgg = CalcAgg<T, expr::calc::Min, CALC_AGG_MIN>;
 
 template <typename T>
-using MaxAgg = CalcAgg<T, expr::calc::Max>;
+using MaxAgg = CalcAgg<T, expr::calc::Max, CALC_AGG_MAX>;
 
 }  // namespace dingodb::rel::op
 
@@ -12,11 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "ungrouped_agg_op.h"
+#include "agg_op.h"
+
+#include <algorithm>
+#include <new>
 
 namespace dingodb::rel::op {
 
-AggOp::AggOp(const std::vector<const Agg *> *aggs) : m_aggs(aggs) {
+AggOp::AggOp(const std::vector<const Agg *> *aggs) : m_aggs(aggs), m_states_size(0), m_states_align(1) {
+  for (const auto *agg : *m_aggs) {
+    auto align = agg->StateAlign();
+    m_states_size = (m_states_size + align - 1) / align * align;
+    m_offsets.push_back(m_states_size);
+    m_states_size += agg->StateSize();
+    m_states_align = std::max(m_states_align, align);
+  }
 }
 
 AggOp::~AggOp() {
@@ -26,14 +36,46 @@ AggOp::~AggOp() {
   delete m_aggs;
 }
 
-void AggOp::AddToCache(expr::Tuple *&cache, const expr::Tuple *tuple) const {
-  if (cache == nullptr) {
-    cache = new expr::Tuple(m_aggs->size());
+char *AggOp::NewStates() const {
+  auto *states = static_cast<char *>(::operator new(m_states_size, std::align_val_t(m_states_align)));
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*m_aggs)[i]->Init(states + m_offsets[i]);
+  }
+  return states;
+}
+
+void AggOp::Update(char *states, const expr::Tuple *tuple) const {
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*m_aggs)[i]->Update(states + m_offsets[i], tuple);
+  }
+}
+
+void AggOp::UpdateRow(char *states, const expr::Batch *batch, size_t row) const {
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*m_aggs)[i]->UpdateRow(states + m_offsets[i], batch, row);
   }
-  for (int i = 0; i < m_aggs->size(); ++i) {
-    (*cache)[i] = (*m_aggs)[i]->Add((*cache)[i], tuple);
+}
+
+void AggOp::UpdateSelected(char *states, const expr::Batch *batch, const uint64_t *selection) const {
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*m_aggs)[i]->UpdateSelected(states + m_offsets[i], batch, selection);
+  }
+}
+
+expr::Tuple *AggOp::Finalize(char *states) const {
+  auto *tuple = new expr::Tuple(m_aggs->size());
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*tuple)[i] = (*m_aggs)[i]->Finalize(states + m_offsets[i]);
+  }
+  DeleteStates(states);
+  return tuple;
+}
+
+void AggOp::DeleteStates(char *states) const {
+  for (size_t i = 0; i < m_aggs->size(); ++i) {
+    (*m_aggs)[i]->Destroy(states + m_offsets[i]);
   }
-  delete tuple;
+  ::operator delete(states, std::align_val_t(m_states_align));
 }
 
 }  // namespace dingodb::rel::op
@@ -30,7 +30,29 @@ class AggOp : public RelOp {
  protected:
   const std::vector<const Agg *> *m_aggs;
 
-  void AddToCache(expr::Tuple *&cache, const expr::Tuple *tuple) const;
+  /**
+   * @brief Allocate and initialize the states of all the aggregations, in one block.
+   */
+  char *NewStates() const;
+
+  void Update(char *states, const expr::Tuple *tuple) const;
+
+  void UpdateRow(char *states, const expr::Batch *batch, size_t row) const;
+
+  void UpdateSelected(char *states, const expr::Batch *batch, const uint64_t *selection) const;
+
+  /**
+   * @brief Get the results of all the aggregations, the states are deleted.
+   */
+  expr::Tuple *Finalize(char *states) const;
+
+  void DeleteStates(char *states) const;
+
+ private:
+  // Offsets of the state of each aggregation in the block.
+  std::vector<size_t> m_offsets;
+  size_t m_states_size;
+  size_t m_states_align;
 };
 
 }  // namespace dingodb::rel::op
@@ -14,6 +14,10 @@
 
 #include "filter_op.h"
 
+#include <algorithm>
+#include <memory>
+#include <variant>
+
 #include "../../expr/calc/special.h"
 #include "../../expr/runner.h"
 
@@ -37,4 +41,35 @@ const expr::Tuple *FilterOp::Put(const expr::Tuple *tuple) const {
   return nullptr;
 }
 
+const expr::Batch *FilterOp::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  // Owned here till forwarded, not to leak it if running the filter throws.
+  std::unique_ptr<const expr::Batch> in(batch);
+  m_filter->RunBatch(batch, selection);
+  auto column = m_filter->GetColumn();
+  // Not to read the values of other types as bools, throw as `Put` does.
+  if (column.GetType() != expr::TYPE_BOOL) {
+    throw std::bad_variant_access();
+  }
+  const auto *values = column.Values<bool>();
+  const auto *validity = column.Validity();
+  auto size = batch->Size();
+  auto words = expr::Column::ValidityWords(size);
+  std::shared_ptr<uint64_t[]> result(new uint64_t[words]);
+  for (size_t w = 0; w < words; ++w) {
+    auto base = w << 6;
+    auto num = std::min<size_t>(64, size - base);
+    uint64_t bits = 0;
+    for (size_t j = 0; j < num; ++j) {
+      bits |= static_cast<uint64_t>(values[base + j]) << j;
+    }
+    bits &= validity[w];
+    if (selection != nullptr) {
+      bits &= selection[w];
+    }
+    result[w] = bits;
+  }
+  selection = std::move(result);
+  return in.release();
+}
+
 }  // namespace dingodb::rel::op
@@ -14,10 +14,109 @@
 
 #include "grouped_agg_op.h"
 
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
 #include "../../expr/utils.h"
 
 namespace dingodb::rel::op {
 
+namespace {
+
+template <typename T>
+void AppendBytes(std::string &buf, T v) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &v, sizeof(T));
+  buf.append(bytes, sizeof(T));
+}
+
+// Append the key of a value to `buf`: the type byte, followed by bytes identical for equal values. Variable-length
+// ones are prefixed by the length, so the keys of the columns concatenated are not ambiguous.
+template <typename T>
+void AppendKey(std::string &buf, const T &v) {
+  if constexpr (std::is_same_v<T, expr::String>) {
+    buf.push_back(static_cast<char>(expr::TYPE_STRING));
+    AppendBytes(buf, static_cast<uint32_t>(v->size()));
+    buf.append(*v);
+  } else if constexpr (std::is_same_v<T, types::DecimalP>) {
+    buf.push_back(static_cast<char>(expr::TYPE_DECIMAL));
+    auto pos = buf.size();
+    AppendBytes(buf, static_cast<uint32_t>(0));
+    v.AppendKey(buf);
+    auto len = static_cast<uint32_t>(buf.size() - pos - sizeof(uint32_t));
+    std::memcpy(&buf[pos], &len, sizeof(uint32_t));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    buf.push_back(static_cast<char>(std::is_same_v<T, float> ? expr::TYPE_FLOAT : expr::TYPE_DOUBLE));
+    // -0.0 equals 0.0.
+    AppendBytes(buf, v == 0 ? T(0) : v);
+  } else {
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, bool>);
+    buf.push_back(static_cast<char>(
+        std::is_same_v<T, int32_t> ? expr::TYPE_INT32 : (std::is_same_v<T, int64_t> ? expr::TYPE_INT64 : expr::TYPE_BOOL)
+    ));
+    AppendBytes(buf, v);
+  }
+}
+
+void AppendKey(std::string &buf, const expr::Operand &v) {
+  if (v == nullptr) {
+    buf.push_back(static_cast<char>(expr::TYPE_NULL));
+  } else if (v.Is<int32_t>()) {
+    AppendKey(buf, v.GetValue<int32_t>());
+  } else if (v.Is<int64_t>()) {
+    AppendKey(buf, v.GetValue<int64_t>());
+  } else if (v.Is<bool>()) {
+    AppendKey(buf, v.GetValue<bool>());
+  } else if (v.Is<float>()) {
+    AppendKey(buf, v.GetValue<float>());
+  } else if (v.Is<double>()) {
+    AppendKey(buf, v.GetValue<double>());
+  } else if (v.Is<expr::String>()) {
+    AppendKey(buf, v.GetValue<expr::String>());
+  } else {
+    // Only decimals are left as scalar values, others throw `std::bad_variant_access`.
+    AppendKey(buf, v.GetValue<types::DecimalP>());
+  }
+}
+
+// The counterpart of the above for a row of a column, the same for the same value.
+void AppendKey(std::string &buf, const expr::Column &column, size_t row) {
+  if (column.IsNull(row)) {
+    buf.push_back(static_cast<char>(expr::TYPE_NULL));
+    return;
+  }
+  switch (column.GetType()) {
+  case expr::TYPE_INT32:
+    AppendKey(buf, column.Values<int32_t>()[row]);
+    break;
+  case expr::TYPE_INT64:
+  case expr::TYPE_DATE:
+  case expr::TYPE_TIMESTAMP:
+    AppendKey(buf, column.Values<int64_t>()[row]);
+    break;
+  case expr::TYPE_BOOL:
+    AppendKey(buf, column.Values<bool>()[row]);
+    break;
+  case expr::TYPE_FLOAT:
+    AppendKey(buf, column.Values<float>()[row]);
+    break;
+  case expr::TYPE_DOUBLE:
+    AppendKey(buf, column.Values<double>()[row]);
+    break;
+  case expr::TYPE_DECIMAL:
+    AppendKey(buf, column.Values<types::DecimalP>()[row]);
+    break;
+  case expr::TYPE_STRING:
+    AppendKey(buf, column.Values<expr::String>()[row]);
+    break;
+  default:
+    AppendKey(buf, column.GetOperand(row));
+  }
+}
+
+}  // namespace
+
 GroupedAggOp::GroupedAggOp(const int *group_indices, size_t group_indices_size, const std::vector<const Agg *> *aggs)
     : AggOp(aggs)
     , m_group_indices(group_indices)
@@ -27,23 +126,55 @@ GroupedAggOp::GroupedAggOp(const int *group_indices, size_t group_indices_size,
 GroupedAggOp::~GroupedAggOp() {
   delete[] m_group_indices;
   for (auto &e : m_caches) {
-    delete e.second;
+    DeleteStates(e.second.states);
   }
 }
 
 const expr::Tuple *GroupedAggOp::Put(const expr::Tuple *tuple) const {
-  auto *key = expr::MapTuple(*tuple, m_group_indices, m_groupe_indices_size);
-  auto *&cache = m_caches[*key];
-  delete key;
-  AddToCache(cache, tuple);
+  m_key.clear();
+  for (size_t i = 0; i < m_groupe_indices_size; ++i) {
+    AppendKey(m_key, (*tuple)[m_group_indices[i]]);
+  }
+  auto it = m_caches.find(m_key);
+  if (it == m_caches.end()) {
+    std::unique_ptr<expr::Tuple> values(expr::MapTuple(*tuple, m_group_indices, m_groupe_indices_size));
+    // Kept longer than the row.
+    for (auto &v : *values) {
+      v = v.Owned();
+    }
+    it = m_caches.emplace(m_key, Group{std::move(*values), NewStates()}).first;
+  }
+  Update(it->second.states, tuple);
+  delete tuple;
+  return nullptr;
+}
+
+const expr::Batch *GroupedAggOp::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  expr::ForEachSelected(selection.get(), batch->Size(), [&](size_t row) {
+    m_key.clear();
+    for (size_t i = 0; i < m_groupe_indices_size; ++i) {
+      AppendKey(m_key, (*batch)[m_group_indices[i]], row);
+    }
+    auto it = m_caches.find(m_key);
+    if (it == m_caches.end()) {
+      expr::Tuple values(m_groupe_indices_size);
+      for (size_t i = 0; i < m_groupe_indices_size; ++i) {
+        values[i] = (*batch)[m_group_indices[i]].GetOperand(row).Owned();
+      }
+      it = m_caches.emplace(m_key, Group{std::move(values), NewStates()}).first;
+    }
+    UpdateRow(it->second.states, batch, row);
+  });
+  delete batch;
   return nullptr;
 }
 
 const expr::Tuple *GroupedAggOp::Get() const {
   if (!m_caches.empty()) {
     auto i = m_caches.begin();
-    auto *tuple = expr::ConcatTuple(i->first, *(i->second));
-    delete i->second;
+    auto *values = Finalize(i->second.states);
+    auto *tuple = expr::ConcatTuple(i->second.values, *values);
+    delete values;
     m_caches.erase(i);
     return tuple;
   }
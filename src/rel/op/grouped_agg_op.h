@@ -15,6 +15,7 @@
 #ifndef _REL_OP_GROUPED_AGG_OP_H_
 #define _REL_OP_GROUPED_AGG_OP_H_
 
+#include <string>
 #include <unordered_map>
 
 #include "agg.h"
@@ -30,13 +31,27 @@ class GroupedAggOp : public AggOp {
 
   const expr::Tuple *Put(const expr::Tuple *tuple) const override;
 
+  const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const override;
+
   const expr::Tuple *Get() const override;
 
  private:
+  /**
+   * @brief The values of the group columns, as first seen, and the states of the aggregations.
+   */
+  struct Group {
+    expr::Tuple values;
+    char *states;
+  };
+
   const int *m_group_indices;
   size_t m_groupe_indices_size;
 
-  mutable std::unordered_map<expr::Tuple, expr::Tuple *, std::hash<expr::Tuple>> m_caches;
+  // Map the encoded group keys to the groups, see `AppendKey`. Equal values, e.g. decimals 1.50 and 1.5, have the same
+  // bytes, so no boxed tuple is made or hashed for each row.
+  mutable std::unordered_map<std::string, Group> m_caches;
+  // The buffer to encode the key of a row.
+  mutable std::string m_key;
 };
 
 }  // namespace dingodb::rel::op
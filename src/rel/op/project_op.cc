@@ -29,7 +29,19 @@ const expr::Tuple *ProjectOp::Put(const expr::Tuple *tuple) const {
   m_projects->BindTuple(tuple);
   m_projects->Run();
   delete tuple;
-  return m_projects->GetAll();
+  auto *result = m_projects->GetAll();
+  // The result may be kept after the row, but strings passed through may view the buffers of the caller.
+  for (auto &v : *result) {
+    v = v.Owned();
+  }
+  return result;
+}
+
+const expr::Batch *ProjectOp::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  m_projects->RunBatch(batch, selection);
+  const auto *result = m_projects->GetAllColumns();
+  delete batch;
+  return result;
 }
 
 }  // namespace dingodb::rel::op
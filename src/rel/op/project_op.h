@@ -31,6 +31,8 @@ class ProjectOp : public RelOp {
 
   const expr::Tuple *Put(const expr::Tuple *tuple) const override;
 
+  const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const override;
+
  private:
   const expr::Runner *m_projects;
 };
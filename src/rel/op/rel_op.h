@@ -15,6 +15,9 @@
 #ifndef _REL_OP_REL_OP_H_
 #define _REL_OP_REL_OP_H_
 
+#include <memory>
+
+#include "../../expr/batch.h"
 #include "../../expr/operand.h"
 
 namespace dingodb::rel {
@@ -29,6 +32,15 @@ class RelOp {
   virtual const expr::Tuple *Get() const {
     return nullptr;
   }
+
+  /**
+   * @brief The counterpart of `Put` for batch mode, in which rows are not moved but selected by a bitmap.
+   *
+   * @param batch the input batch, which is taken over
+   * @param selection the bitmap of the rows selected, `nullptr` for all rows; filters narrow it down in place
+   * @return the output batch, which must be released by the caller, or `nullptr` if the rows are consumed
+   */
+  virtual const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const = 0;
 };
 
 }  // namespace dingodb::rel
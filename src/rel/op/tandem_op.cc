@@ -32,6 +32,14 @@ const expr::Tuple *TandemOp::Put(const expr::Tuple *tuple) const {
   return nullptr;
 }
 
+const expr::Batch *TandemOp::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  const auto *b = m_in->PutBatch(batch, selection);
+  if (b != nullptr) {
+    return m_out->PutBatch(b, selection);
+  }
+  return nullptr;
+}
+
 const expr::Tuple *TandemOp::Get() const {
   const expr::Tuple *tuple;
   while ((tuple = m_in->Get()) != nullptr) {
@@ -26,6 +26,8 @@ class TandemOp : public RelOp {
   ~TandemOp() override;
 
   const expr::Tuple *Put(const expr::Tuple *tuple) const override;
+
+  const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const override;
   const expr::Tuple *Get() const override;
 
  private:
@@ -20,11 +20,26 @@ UngroupedAggOp::UngroupedAggOp(const std::vector<const Agg *> *aggs) : AggOp(agg
 }
 
 UngroupedAggOp::~UngroupedAggOp() {
-  delete m_cache;
+  if (m_cache != nullptr) {
+    DeleteStates(m_cache);
+  }
 }
 
 const expr::Tuple *UngroupedAggOp::Put(const expr::Tuple *tuple) const {
-  AddToCache(m_cache, tuple);
+  if (m_cache == nullptr) {
+    m_cache = NewStates();
+  }
+  Update(m_cache, tuple);
+  delete tuple;
+  return nullptr;
+}
+
+const expr::Batch *UngroupedAggOp::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  if (m_cache == nullptr) {
+    m_cache = NewStates();
+  }
+  UpdateSelected(m_cache, batch, selection.get());
+  delete batch;
   return nullptr;
 }
 
@@ -32,7 +47,7 @@ const expr::Tuple *UngroupedAggOp::Get() const {
   if (m_cache != nullptr) {
     auto *p = m_cache;
     m_cache = nullptr;
-    return p;
+    return Finalize(p);
   }
   return nullptr;
 }
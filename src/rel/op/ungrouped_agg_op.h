@@ -28,10 +28,13 @@ class UngroupedAggOp : public AggOp {
 
   const expr::Tuple *Put(const expr::Tuple *tuple) const override;
 
+  const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const override;
+
   const expr::Tuple *Get() const override;
 
  private:
-  mutable expr::Tuple *m_cache;
+  // The states of the aggregations.
+  mutable char *m_cache;
 };
 
 }  // namespace dingodb::rel::op
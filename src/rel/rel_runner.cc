@@ -104,6 +104,10 @@ const expr::Tuple *RelRunner::Put(const expr::Tuple *tuple) const {
   return m_op->Put(tuple);
 }
 
+const expr::Batch *RelRunner::PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const {
+  return m_op->PutBatch(batch, selection);
+}
+
 const expr::Tuple *RelRunner::Get() const {
   return m_op->Get();
 }
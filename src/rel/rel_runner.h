@@ -33,6 +33,15 @@ class RelRunner {
 
   const expr::Tuple *Get() const;
 
+  /**
+   * @brief Put a batch of rows, the rows passing filters are marked in `selection` instead of being moved.
+   *
+   * @param batch the input batch, which is taken over
+   * @param selection the bitmap of the rows selected, `nullptr` for all rows; narrowed down by filters in place
+   * @return the output batch, which must be released by the caller, or `nullptr` if the rows are aggregated
+   */
+  const expr::Batch *PutBatch(const expr::Batch *batch, std::shared_ptr<uint64_t[]> &selection) const;
+
  private:
   RelOp *m_op;
 
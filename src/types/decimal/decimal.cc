@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include "decimal.h"
@@ -73,6 +74,32 @@ Decimal::Decimal(double var) : v(mpf_class(var)) {
   PRINT_DECIMAL;
 }
 
+int Decimal::compare(const Decimal &dec) const {
+  int ret = cmp(v, dec.v);
+  // Different signs, or one is zero.
+  if (ret == 0 || sgn(v) != sgn(dec.v)) {
+    return ret;
+  }
+  long exp0;
+  long exp1;
+  mpf_get_d_2exp(&exp0, v.get_mpf_t());
+  mpf_get_d_2exp(&exp1, dec.v.get_mpf_t());
+  if (exp0 - exp1 > 1 || exp1 - exp0 > 1) {
+    return ret;
+  }
+  // The values differ only in the last bits if the difference is less than 2^-(prec - guard) of them, which may be
+  // rounded off by formatting, so compare them as formatted as before.
+  static const long GUARD_BITS = 8;
+  mpf_class diff(v - dec.v, 64);
+  long expDiff;
+  mpf_get_d_2exp(&expDiff, diff.get_mpf_t());
+  long prec = std::min(v.get_prec(), dec.v.get_prec());
+  if (std::max(exp0, exp1) - expDiff < prec - GUARD_BITS) {
+    return ret;
+  }
+  return cmp(mpf_class(toString(), MAX_PRECISION, BASE), mpf_class(dec.toString(), MAX_PRECISION, BASE));
+}
+
 std::string Decimal::toString() const {
   mp_exp_t exp;
   std::string result;
@@ -213,20 +213,21 @@ class Decimal {
     return std::move(Decimal(ret));
   }
 
+  /**
+   * Compare with another decimal, which may be of different precision, without formatting them unless they are
+   * equal to the precision.
+   * @param dec
+   * @return negative, zero or positive if this is less than, equal to or greater than `dec`
+   */
+  int compare(const Decimal &dec) const;
+
     /**
    * decimal == decimal.
    * @param dec
    * @return
    */
     bool operator==(const Decimal &dec) const {
-      const mpf_class& mpf1 = mpf_class(toString());
-      const mpf_class& mpf2 = mpf_class(dec.toString());
-
-      int ret = cmp(mpf1, mpf2);
-      if(ret == 0) {
-        return true;
-      }
-      return false;
+      return compare(dec) == 0;
     }
 
     /**
@@ -244,14 +245,7 @@ class Decimal {
      * @return
      */
     bool operator<(const Decimal &dec) const {
-      const mpf_class& mpf1 = mpf_class(toString());
-      const mpf_class& mpf2 = mpf_class(dec.toString());
-
-      int ret = cmp(mpf1, mpf2);
-      if(ret < 0) {
-        return true;
-      }
-      return false;
+      return compare(dec) < 0;
     }
 
     /**
@@ -260,14 +254,7 @@ class Decimal {
      * @return
      */
     bool operator<=(const Decimal &dec) const {
-      const mpf_class& mpf1 = mpf_class(toString());
-      const mpf_class& mpf2 = mpf_class(dec.toString());
-
-      int ret = cmp(mpf1, mpf2);
-      if(ret <= 0) {
-        return true;
-      }
-      return false;
+      return compare(dec) <= 0;
     }
 
     /**
@@ -276,14 +263,7 @@ class Decimal {
      * @return
      */
     bool operator>(const Decimal &dec) const {
-      const mpf_class& mpf1 = mpf_class(toString());
-      const mpf_class& mpf2 = mpf_class(dec.toString());
-
-      int ret = cmp(mpf1, mpf2);
-      if(ret > 0) {
-        return true;
-      }
-      return false;
+      return compare(dec) > 0;
     }
 
     /**
@@ -292,14 +272,7 @@ class Decimal {
      * @return
      */
     bool operator>=(const Decimal &dec) const {
-      const mpf_class& mpf1 = mpf_class(toString());
-      const mpf_class& mpf2 = mpf_class(dec.toString());
-
-      int ret = cmp(mpf1, mpf2);
-      if(ret >= 0) {
-        return true;
-      }
-      return false;
+      return compare(dec) >= 0;
     }
 
     /**
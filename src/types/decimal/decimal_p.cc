@@ -14,13 +14,287 @@
 
 #include "decimal_p.h"
 
+#include <cstdlib>
+#include <string_view>
+
 namespace dingodb {
 namespace types {
 
+namespace {
+
+struct Pow10Table {
+  int128_t values[MAX_FIXED_SCALE + 1];
+
+  constexpr Pow10Table() : values() {
+    values[0] = 1;
+    for (int i = 1; i <= MAX_FIXED_SCALE; ++i) {
+      values[i] = values[i - 1] * 10;
+    }
+  }
+};
+
+constexpr Pow10Table POW10;
+
+// Exact powers of 10 in double.
+constexpr double DOUBLE_POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+constexpr int MAX_DOUBLE_EXACT_SCALE = 22;
+
+constexpr int128_t MAX_DOUBLE_EXACT_INT = static_cast<int128_t>(1) << 53;
+
+unsigned __int128 Abs128(int128_t v) {
+  return v < 0 ? -static_cast<unsigned __int128>(v) : static_cast<unsigned __int128>(v);
+}
+
+// Make a mpf of `u` exactly, from the two 64-bit halves.
+mpf_class ToMpf(unsigned __int128 u) {
+  mpf_class v(static_cast<unsigned long>(u >> 64), MAX_PRECISION);
+  mpf_mul_2exp(v.get_mpf_t(), v.get_mpf_t(), 64);
+  v += static_cast<unsigned long>(u);
+  return v;
+}
+
+unsigned __int128 Gcd128(unsigned __int128 a, unsigned __int128 b) {
+  while (b != 0) {
+    auto t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Parse `-?digits(.digits)?` into `unscaled` and `scale`, return false if not in this form or not fit.
+bool ParseFixed(const std::string &str, int128_t &unscaled, int &scale) {
+  size_t i = 0;
+  size_t len = str.length();
+  bool negative = false;
+  if (i < len && str[i] == '-') {
+    negative = true;
+    ++i;
+  }
+  // Accumulate in negative to hold the min value.
+  int128_t value = 0;
+  size_t digits = 0;
+  for (; i < len && '0' <= str[i] && str[i] <= '9'; ++i, ++digits) {
+    if (__builtin_mul_overflow(value, 10, &value) || __builtin_sub_overflow(value, str[i] - '0', &value)) {
+      return false;
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+  scale = 0;
+  if (i < len && str[i] == '.') {
+    ++i;
+    for (; i < len && '0' <= str[i] && str[i] <= '9'; ++i, ++scale) {
+      if (scale == MAX_FIXED_SCALE || __builtin_mul_overflow(value, 10, &value) ||
+          __builtin_sub_overflow(value, str[i] - '0', &value)) {
+        return false;
+      }
+    }
+    if (scale == 0) {
+      return false;
+    }
+  }
+  // Same as `Decimal`, the value ends at the first char not valid, but leave the special ones to it.
+  if (i < len && (str[i] == '.' || str[i] == 'e' || str[i] == 'E' || str[i] == '-' || str[i] == '+')) {
+    return false;
+  }
+  if (negative) {
+    unscaled = value;
+  } else if (__builtin_sub_overflow(static_cast<int128_t>(0), value, &unscaled)) {
+    return false;
+  }
+  return true;
+}
+
+constexpr size_t FIXED_KEY_SIZE = 1 + sizeof(int128_t);
+
+constexpr char NOT_FIXED_KEY = '\xFF';
+
+bool IsValidChar(char c) {
+  return ('0' <= c && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '-' || c == '+';
+}
+
+}  // namespace
+
+int128_t Pow10(int n) {
+  return POW10.values[n];
+}
+
+DecimalP::DecimalP(const std::string &str) : m_unscaled(0), m_scale(0) {
+  if (ParseFixed(str, m_unscaled, m_scale)) {
+    return;
+  }
+  // `Decimal` takes it as 0 if it starts with no valid char.
+  if (str.empty() || !IsValidChar(str[0])) {
+    m_unscaled = 0;
+    m_scale = 0;
+    return;
+  }
+  m_scale = GMP_SCALE;
+  m_ptr = std::make_shared<Decimal>(str);
+}
+
+DecimalP::ValueType DecimalP::GetPtr() const {
+  if (!IsFixed()) {
+    return m_ptr;
+  }
+  auto v = ToMpf(Abs128(m_unscaled));
+  if (m_scale > 0) {
+    v /= ToMpf(static_cast<unsigned __int128>(Pow10(m_scale)));
+  }
+  if (m_unscaled < 0) {
+    v = -v;
+  }
+  return std::make_shared<Decimal>(v);
+}
+
+double DecimalP::toDouble() const {
+  if (!IsFixed()) {
+    return m_ptr->toDouble();
+  }
+  if (m_scale <= MAX_DOUBLE_EXACT_SCALE && -MAX_DOUBLE_EXACT_INT <= m_unscaled && m_unscaled <= MAX_DOUBLE_EXACT_INT) {
+    // Both are exact, so is the quotient correctly rounded.
+    return static_cast<double>(m_unscaled) / DOUBLE_POW10[m_scale];
+  }
+  return std::strtod(FixedToString().c_str(), nullptr);
+}
+
+DecimalP DecimalP::operator/(const DecimalP &v) const {
+  if (IsFixed() && v.IsFixed() && v.m_unscaled != 0) {
+    // Only the quotient terminating in `MAX_FIXED_SCALE` digits is fixed-point, i.e. the divisor reduced has no prime
+    // factors other than 2 and 5.
+    auto a = Abs128(m_unscaled);
+    auto b = Abs128(v.m_unscaled);
+    auto g = Gcd128(a, b);
+    a /= g;
+    b /= g;
+    int twos = 0;
+    int fives = 0;
+    auto d = b;
+    for (; d % 2 == 0 && twos <= MAX_FIXED_SCALE; d /= 2) {
+      ++twos;
+    }
+    for (; d % 5 == 0 && fives <= MAX_FIXED_SCALE; d /= 5) {
+      ++fives;
+    }
+    int k = twos > fives ? twos : fives;
+    int scale = k + m_scale - v.m_scale;
+    if (d == 1 && k <= MAX_FIXED_SCALE && scale <= MAX_FIXED_SCALE) {
+      // `b` divides 10^k.
+      unsigned __int128 m = static_cast<unsigned __int128>(Pow10(k)) / b;
+      bool overflow = false;
+      if (scale < 0) {
+        overflow = __builtin_mul_overflow(m, static_cast<unsigned __int128>(Pow10(-scale)), &m);
+        scale = 0;
+      }
+      unsigned __int128 q;
+      if (!overflow && !__builtin_mul_overflow(a, m, &q) && q <= static_cast<unsigned __int128>(MIN_UNSCALED) - 1) {
+        int128_t r = static_cast<int128_t>(q);
+        return DecimalP((m_unscaled < 0) != (v.m_unscaled < 0) ? -r : r, scale);
+      }
+    }
+  }
+  return *GetPtr() / *v.GetPtr();
+}
+
+DecimalP DecimalP::Normalize() const {
+  int128_t unscaled;
+  int scale;
+  if (IsFixed()) {
+    unscaled = m_unscaled;
+    scale = m_scale;
+  } else if (!ParseFixed(m_ptr->toString(), unscaled, scale)) {
+    return *this;
+  }
+  for (; scale > 0 && unscaled % 10 == 0; --scale) {
+    unscaled /= 10;
+  }
+  return DecimalP(unscaled, scale);
+}
+
+void DecimalP::EncodeFixedKey(char *buf) const {
+  buf[0] = static_cast<char>(m_scale);
+  auto u = static_cast<unsigned __int128>(m_unscaled);
+  for (size_t i = 1; i < FIXED_KEY_SIZE; ++i) {
+    buf[i] = static_cast<char>(u & 0xFF);
+    u >>= 8;
+  }
+}
+
+void DecimalP::AppendKey(std::string &buf) const {
+  auto v = Normalize();
+  if (v.IsFixed()) {
+    char key[FIXED_KEY_SIZE];
+    v.EncodeFixedKey(key);
+    buf.append(key, FIXED_KEY_SIZE);
+  } else {
+    buf.push_back(NOT_FIXED_KEY);
+    buf.append(v.m_ptr->toString());
+  }
+}
+
+size_t DecimalP::Hash() const {
+  auto v = Normalize();
+  if (v.IsFixed()) {
+    char key[FIXED_KEY_SIZE];
+    v.EncodeFixedKey(key);
+    return std::hash<std::string_view>()(std::string_view(key, FIXED_KEY_SIZE));
+  }
+  return std::hash<std::string>()(v.m_ptr->toString());
+}
+
+int64_t DecimalP::Round() const {
+  if (m_scale == 0) {
+    return static_cast<int64_t>(m_unscaled);
+  }
+  auto p = Pow10(m_scale);
+  auto q = m_unscaled / p;
+  auto r = m_unscaled % p;
+  if (2 * Abs128(r) >= static_cast<unsigned __int128>(p)) {
+    q += (m_unscaled < 0 ? -1 : 1);
+  }
+  return static_cast<int64_t>(q);
+}
+
+std::string DecimalP::FixedToString() const {
+  // 39 digits at most, plus sign, point and a leading zero.
+  char buf[48];
+  char *end = buf + sizeof(buf);
+  char *p = end;
+  auto u = Abs128(m_unscaled);
+  int scale = m_scale;
+  // Strip the trailing zeros of the fraction.
+  for (; scale > 0 && u % 10 == 0; --scale) {
+    u /= 10;
+  }
+  for (int i = 0; i < scale; ++i) {
+    *--p = static_cast<char>('0' + static_cast<int>(u % 10));
+    u /= 10;
+  }
+  if (scale > 0) {
+    *--p = '.';
+  }
+  do {
+    *--p = static_cast<char>('0' + static_cast<int>(u % 10));
+    u /= 10;
+  } while (u != 0);
+  if (m_unscaled < 0) {
+    *--p = '-';
+  }
+  return std::string(p, end);
+}
+
+int DecimalP::CompareSlow(const DecimalP &v) const {
+  return GetPtr()->compare(*v.GetPtr());
+}
+
 std::ostream &operator<<(std::ostream &os, const DecimalP &v) {
-  os << *(v.m_ptr);
+  os << v.ToString();
   return os;
 }
 
 }  // namespace types
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
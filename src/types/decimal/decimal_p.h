@@ -16,118 +16,274 @@
 #define DINGO_LIBEXPR_DECIMAL_P_H
 
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <ostream>
+#include <string>
 
 #include "decimal.h"
 
 namespace dingodb {
 namespace types {
 
+using int128_t = __int128;
+
+/**
+ * The max scale of a fixed-point decimal, 10^38 is the max power of 10 fits in `int128_t`.
+ */
+const int MAX_FIXED_SCALE = 38;
+
+/**
+ * Get 10^n, `n` must be in [0, MAX_FIXED_SCALE].
+ */
+int128_t Pow10(int n);
+
+/**
+ * Decimal value used in expressions.
+ *
+ * A value is kept in fixed-point, as an unscaled `int128_t` and a scale, as long as it fits, so that the arithmetic
+ * and comparison need no GMP and no allocation. Otherwise, e.g. the result of a division which does not terminate or
+ * a value converted from double, it falls back to a `Decimal` in GMP.
+ */
 class DecimalP {
  public:
   using ValueType = std::shared_ptr<Decimal>;
 
-  DecimalP(const std::shared_ptr<Decimal> &ptr) : m_ptr(ptr) {
+  /**
+   * Gives access to the `Decimal` by `->`, which is made on the fly for a fixed-point value.
+   */
+  class DecimalRef {
+   public:
+    DecimalRef(ValueType ptr) : m_ptr(std::move(ptr)) {
+    }
+
+    const Decimal *operator->() const {
+      return m_ptr.get();
+    }
+
+   private:
+    ValueType m_ptr;
+  };
+
+  DecimalP(const std::shared_ptr<Decimal> &ptr) : m_unscaled(0), m_scale(GMP_SCALE), m_ptr(ptr) {
+  }
+
+  DecimalP(const Decimal &dec) : m_unscaled(0), m_scale(GMP_SCALE), m_ptr(std::make_shared<Decimal>(dec)) {
+  }
+
+  DecimalP(const long var) : m_unscaled(var), m_scale(0) {
   }
 
-  DecimalP(const Decimal &dec) : m_ptr(std::make_shared<Decimal>(dec)) {
+  DecimalP(const double var) : m_unscaled(0), m_scale(GMP_SCALE), m_ptr(std::make_shared<Decimal>(var)) {
   }
 
-  DecimalP(const long var) : m_ptr(std::make_shared<Decimal>(var)){
+  DecimalP(const std::string &str);
+
+  /**
+   * Make a fixed-point value of `unscaled * 10^-scale`, `scale` must be in [0, MAX_FIXED_SCALE].
+   */
+  DecimalP(int128_t unscaled, int scale) : m_unscaled(unscaled), m_scale(scale) {
   }
 
-  DecimalP(const double var) : m_ptr(std::make_shared<Decimal>(var)) {
+  DecimalP() : m_unscaled(0), m_scale(0) {
   }
 
-  DecimalP(const std::string& str) : m_ptr(std::make_shared<Decimal>(str)) {
+  bool IsFixed() const {
+    return m_scale != GMP_SCALE;
   }
 
-  DecimalP() : m_ptr(std::make_shared<Decimal>()) {
+  int128_t GetUnscaled() const {
+    return m_unscaled;
   }
 
-  ValueType GetPtr() const {
-    return m_ptr;
+  int GetScale() const {
+    return m_scale;
   }
 
-  const Decimal &operator*() const {
-    return *m_ptr;
+  /**
+   * Get the value as a `Decimal`, which is made from the unscaled value for a fixed-point value, without formatting.
+   */
+  ValueType GetPtr() const;
+
+  Decimal operator*() const {
+    return *GetPtr();
   }
 
-  const Decimal *operator->() const {
-    return &*m_ptr;
+  DecimalRef operator->() const {
+    return DecimalRef(GetPtr());
   }
 
   int32_t toInt() const {
+    if (IsFixed()) {
+      return static_cast<int32_t>(Round());
+    }
     double ret = m_ptr->toDouble();
     int32_t const r = std::llround(ret);
     return r;
   }
 
   int64_t toLong() const {
+    if (IsFixed()) {
+      return Round();
+    }
     double ret = m_ptr->toDouble();
-    int32_t const r = std::llround(ret);
+    int64_t const r = std::llround(ret);
     return r;
   }
 
-  double toDouble() const {
-    return m_ptr->toDouble();
-  }
+  double toDouble() const;
 
   const std::string ToString() const {
-    return std::move(m_ptr->toString());
+    return IsFixed() ? FixedToString() : m_ptr->toString();
   }
 
+  /**
+   * Get the value in the canonical form, i.e. fixed-point without trailing zeros if it fits, so that equal values have
+   * identical members.
+   */
+  DecimalP Normalize() const;
+
+  /**
+   * Append the canonical bytes of the value to `buf`, which are identical for equal values. It is a byte of the scale
+   * followed by the unscaled value in 16 bytes if the value fits in fixed-point, or `0xFF` followed by the string.
+   */
+  void AppendKey(std::string &buf) const;
+
+  /**
+   * Hash of the canonical bytes.
+   */
+  size_t Hash() const;
+
   DecimalP operator+(const DecimalP &v) const {
-    return *m_ptr + *v.m_ptr;
+    int128_t a;
+    int128_t b;
+    int128_t r;
+    int scale;
+    if (Align(v, a, b, scale) && !__builtin_add_overflow(a, b, &r)) {
+      return DecimalP(r, scale);
+    }
+    return *GetPtr() + *v.GetPtr();
   }
 
   DecimalP operator-(const DecimalP &v) const {
-    return *m_ptr - *v.m_ptr;
+    int128_t a;
+    int128_t b;
+    int128_t r;
+    int scale;
+    if (Align(v, a, b, scale) && !__builtin_sub_overflow(a, b, &r)) {
+      return DecimalP(r, scale);
+    }
+    return *GetPtr() - *v.GetPtr();
   }
 
   DecimalP operator*(const DecimalP &v) const {
-    return *m_ptr * *v.m_ptr;
+    int128_t r;
+    if (IsFixed() && v.IsFixed() && m_scale + v.m_scale <= MAX_FIXED_SCALE &&
+        !__builtin_mul_overflow(m_unscaled, v.m_unscaled, &r)) {
+      return DecimalP(r, m_scale + v.m_scale);
+    }
+    return *GetPtr() * *v.GetPtr();
   }
 
-  DecimalP operator/(const DecimalP &v) const {
-    return *m_ptr / *v.m_ptr;
-  }
+  DecimalP operator/(const DecimalP &v) const;
 
   DecimalP operator-() const {
-    return Decimal("0") - (*m_ptr);
+    if (IsFixed() && m_unscaled != MIN_UNSCALED) {
+      return DecimalP(-m_unscaled, m_scale);
+    }
+    return Decimal("0") - *GetPtr();
+  }
+
+  /**
+   * Compare with another value.
+   * @return negative, zero or positive if this value is less than, equal to or greater than `v`
+   */
+  int Compare(const DecimalP &v) const {
+    int128_t a;
+    int128_t b;
+    int scale;
+    if (Align(v, a, b, scale)) {
+      return (a > b) - (a < b);
+    }
+    return CompareSlow(v);
   }
 
   bool operator==(const DecimalP &v) const {
-    return *m_ptr == *v.m_ptr;
+    return Compare(v) == 0;
   }
 
   bool operator!=(const DecimalP &v) const {
-    return *m_ptr != *v.m_ptr;
+    return Compare(v) != 0;
   }
 
   bool operator<(const DecimalP &v) const {
-    return *m_ptr < *v.m_ptr;
+    return Compare(v) < 0;
   }
 
   bool operator<=(const DecimalP &v) const {
-    return *m_ptr <= *v.m_ptr;
+    return Compare(v) <= 0;
   }
 
   bool operator>(const DecimalP &v) const {
-    return *m_ptr > *v.m_ptr;
+    return Compare(v) > 0;
   }
 
   bool operator>=(const DecimalP &v) const {
-    return *m_ptr >= *v.m_ptr;
+    return Compare(v) >= 0;
   }
 
   DecimalP Abs() {
-    return DecimalP((*m_ptr).Abs());
+    if (IsFixed() && m_unscaled != MIN_UNSCALED) {
+      return DecimalP(m_unscaled < 0 ? -m_unscaled : m_unscaled, m_scale);
+    }
+    return DecimalP((*GetPtr()).Abs());
   }
 
  private:
+  static constexpr int GMP_SCALE = -1;
+  static constexpr int128_t MIN_UNSCALED = static_cast<int128_t>(static_cast<unsigned __int128>(1) << 127);
+
+  int128_t m_unscaled;
+  int m_scale;
+  // Only for values not fixed-point.
   ValueType m_ptr;
 
+  /**
+   * Scale both fixed-point values to the same scale.
+   * @return false if either is not fixed-point or overflows
+   */
+  bool Align(const DecimalP &v, int128_t &a, int128_t &b, int &scale) const {
+    if (!IsFixed() || !v.IsFixed()) {
+      return false;
+    }
+    if (m_scale == v.m_scale) {
+      a = m_unscaled;
+      b = v.m_unscaled;
+      scale = m_scale;
+      return true;
+    }
+    if (m_scale < v.m_scale) {
+      b = v.m_unscaled;
+      scale = v.m_scale;
+      return !__builtin_mul_overflow(m_unscaled, Pow10(v.m_scale - m_scale), &a);
+    }
+    a = m_unscaled;
+    scale = m_scale;
+    return !__builtin_mul_overflow(v.m_unscaled, Pow10(m_scale - v.m_scale), &b);
+  }
+
+  /**
+   * Round half away from zero to integer.
+   */
+  int64_t Round() const;
+
+  std::string FixedToString() const;
+
+  int CompareSlow(const DecimalP &v) const;
+
+  // Write the canonical bytes of a normalized fixed-point value.
+  void EncodeFixedKey(char *buf) const;
+
   friend class Operand;
 
   friend std::ostream &operator<<(std::ostream &os, const DecimalP &v);
@@ -136,13 +292,12 @@ class DecimalP {
 }  // namespace types
 }  // namespace dingodb
 
-//using namespace dingodb::expr;
 namespace std {
 
     template <>
     struct hash<::dingodb::types::DecimalP> {
         size_t operator()(const ::dingodb::types::DecimalP &val) const noexcept {
-            return hash<std::string>()(val->toString());
+            return val.Hash();
         }
     };
 }  // namespace std
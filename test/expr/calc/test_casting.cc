@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <random>
+
 #include "../exception.h"
 #include "casting.h"
 #include "decimal_p.h"
@@ -30,7 +34,7 @@ using namespace dingodb::types;
 
 TEST(TestToString, Cast) {
   ASSERT_EQ(*((calc::Cast<String>(1.0f))), "1.0");
-  ASSERT_EQ(*((calc::Cast<String>(2.30f))), "2.299999952316284");
+  ASSERT_EQ(*((calc::Cast<String>(2.30f))), "2.3");
 
   ASSERT_EQ(*((calc::Cast<String>(2.0))), "2");
   ASSERT_EQ(*((calc::Cast<String>(2.30))), "2.3");
@@ -45,6 +49,56 @@ TEST(TestToString, Cast) {
   ASSERT_EQ(*((calc::Cast<String>(-123.456))), "-123.456");
 }
 
+TEST(TestToString, CastFloatShortest) {
+  ASSERT_EQ(*((calc::Cast<String>(1.2345678f))), "1.2345678");
+  ASSERT_EQ(*((calc::Cast<String>(-0.001f))), "-0.001");
+  ASSERT_EQ(*((calc::Cast<String>(1.0e10f))), "10000000000.0");
+  ASSERT_EQ(*((calc::Cast<String>(1.0e-10f))), "0.0000000001");
+  ASSERT_EQ(*((calc::Cast<String>(0.0f))), "0.0");
+  ASSERT_EQ(*((calc::Cast<String>(std::numeric_limits<float>::infinity()))), "inf");
+  std::mt19937 gen(7);
+  for (int i = 0; i < 100000; ++i) {
+    uint32_t bits = gen();
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    if (!std::isfinite(v)) {
+      continue;
+    }
+    auto s = std::string(*calc::Cast<String>(v));
+    ASSERT_EQ(std::strtof(s.c_str(), nullptr), v) << s;
+    // The same value as the shortest of `%.*g` reading back.
+    char buf[32];
+    for (int precision = 1; precision <= 9; ++precision) {
+      snprintf(buf, sizeof(buf), "%.*g", precision, v);
+      if (std::strtof(buf, nullptr) == v) {
+        break;
+      }
+    }
+    ASSERT_EQ(std::strtod(s.c_str(), nullptr), std::strtod(buf, nullptr)) << s << " " << buf;
+  }
+}
+
+TEST(TestToDecimalP, CastFloatDouble) {
+  ASSERT_EQ(calc::Cast<DecimalP>(12.34).ToString(), "12.34");
+  ASSERT_EQ(calc::Cast<DecimalP>(12.34f).ToString(), "12.34");
+  ASSERT_EQ(calc::Cast<DecimalP>(0.1 + 0.2).ToString(), "0.3");
+  ASSERT_EQ(calc::Cast<DecimalP>(-1.0e-15).ToString(), "0");
+  ASSERT_TRUE(calc::Cast<DecimalP>(-2.5).IsFixed());
+  // The same as formatting in fixed notation and parsing.
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+  std::uniform_int_distribution<int> exponent(-20, 30);
+  char buf[128];
+  for (int i = 0; i < 10000; ++i) {
+    double v = std::ldexp(mantissa(gen), exponent(gen) * 2);
+    snprintf(buf, sizeof(buf), "%.14f", v);
+    ASSERT_EQ(calc::Cast<DecimalP>(v), DecimalP(std::string(buf))) << buf;
+    auto f = static_cast<float>(v);
+    snprintf(buf, sizeof(buf), "%.6f", f);
+    ASSERT_EQ(calc::Cast<DecimalP>(f), DecimalP(std::string(buf))) << buf;
+  }
+}
+
 TEST(TestStringTonumber, Cast) {
   ASSERT_EQ((calc::Cast<int32_t>(String("9a"))), 9);
   ASSERT_EQ((calc::Cast<int64_t>(String("9bb"))), 9);
@@ -57,6 +111,55 @@ TEST(TestStringTonumber, Cast) {
   ASSERT_EQ((calc::Cast<double>(DecimalP(std::string("123.45")))), 123.45);
 }
 
+TEST(TestStringTonumber, CastEdges) {
+  ASSERT_EQ((calc::Cast<int32_t>(String("  \t+42"))), 42);
+  ASSERT_EQ((calc::Cast<int32_t>(String("-2147483648"))), std::numeric_limits<int32_t>::min());
+  ASSERT_EQ((calc::Cast<int64_t>(String("-9223372036854775808"))), std::numeric_limits<int64_t>::min());
+  ASSERT_EQ((calc::Cast<int64_t>(String("1234567890123456789xyz"))), 1234567890123456789LL);
+  ASSERT_EQ((calc::Cast<int32_t>(String("+-1"))), 0);
+  ASSERT_EQ((calc::Cast<int32_t>(String(""))), 0);
+  ASSERT_THROW(calc::Cast<int32_t>(String("2147483648")), ExceedsLimits<TYPE_INT32>);
+  ASSERT_THROW(calc::Cast<int64_t>(String("-9223372036854775809")), ExceedsLimits<TYPE_INT64>);
+  ASSERT_THROW(calc::Cast<int64_t>(String("123456789012345678901234567890")), ExceedsLimits<TYPE_INT64>);
+  ASSERT_EQ((calc::Cast<double>(String(" +1.5e3abc"))), 1500.0);
+  ASSERT_EQ((calc::Cast<double>(String("-.25"))), -0.25);
+  ASSERT_EQ((calc::Cast<double>(String("0x10"))), 16.0);
+  ASSERT_EQ((calc::Cast<double>(String("."))), 0.0);
+  ASSERT_EQ((calc::Cast<double>(String("+-1"))), 0.0);
+  ASSERT_TRUE(std::isinf(calc::Cast<double>(String("-inf"))));
+  ASSERT_TRUE(std::isnan(calc::Cast<float>(String("nan"))));
+  ASSERT_THROW(calc::Cast<double>(String("1e400")), ExceedsLimits<TYPE_DOUBLE>);
+  ASSERT_THROW(calc::Cast<float>(String("1e40")), ExceedsLimits<TYPE_FLOAT>);
+}
+
+TEST(TestStringTonumber, CastSameAsStrtod) {
+  std::mt19937_64 gen(42);
+  std::uniform_real_distribution<double> dis(-1.0e6, 1.0e6);
+  char buf[64];
+  for (int i = 0; i < 10000; ++i) {
+    auto v = dis(gen);
+    snprintf(buf, sizeof(buf), i % 2 == 0 ? "%.*f" : "%.*e", i % 18, v);
+    ASSERT_EQ(calc::Cast<double>(String(buf)), std::strtod(buf, nullptr)) << buf;
+    ASSERT_EQ(calc::Cast<float>(String(buf)), std::strtof(buf, nullptr)) << buf;
+    snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(gen()));
+    ASSERT_EQ(calc::Cast<int64_t>(String(buf)), std::strtoll(buf, nullptr, 10)) << buf;
+  }
+}
+
+TEST(TestStringTonumber, CastStrings) {
+  String in[] = {String("1"), String("junk"), String("-3"), String("4.5")};
+  uint64_t validity = 0b1101;
+  int64_t out[4] = {-1, -1, -1, -1};
+  calc::CastStrings(in, out, &validity, 4);
+  ASSERT_EQ(out[0], 1);
+  ASSERT_EQ(out[1], -1);
+  ASSERT_EQ(out[2], -3);
+  ASSERT_EQ(out[3], 4);
+  double dout[4];
+  calc::CastStrings(in, dout, &validity, 4);
+  ASSERT_EQ(dout[3], 4.5);
+}
+
 TEST(TestToInt32, Cast) {
   ASSERT_THROW(calc::CastCheck<int32_t>((int64_t)std::numeric_limits<int32_t>::max() + 1), ExceedsLimits<TYPE_INT32>);
   ASSERT_THROW(calc::CastCheck<int32_t>((int64_t)std::numeric_limits<int32_t>::min() - 1), ExceedsLimits<TYPE_INT32>);
@@ -70,13 +173,13 @@ TEST(TestToInt32, Cast) {
 
 TEST(TestOtherToDecimalP, Cast) {
   ASSERT_EQ((calc::Cast<int32_t>(DecimalP(std::string("123456.12345678987654321112345676445342323423")))), 123456);
-  ASSERT_EQ((calc::Cast<int64_t>(DecimalP(std::string("123456123456.12345678987654321112345676445342323423")))), -1097928128);
+  ASSERT_EQ((calc::Cast<int64_t>(DecimalP(std::string("123456123456.12345678987654321112345676445342323423")))), INT64_C(123456123456));
 
   //"+1" for mpf is not allow.
   ASSERT_EQ((calc::Cast<int32_t>(DecimalP(std::string("1")))), 1);
   ASSERT_EQ((calc::Cast<int32_t>(DecimalP(std::string("0")))), 0);
   ASSERT_EQ((calc::Cast<int32_t>(DecimalP(std::string("-123456.12345678987654321112345676445342323423")))), -123456);
-  ASSERT_EQ((calc::Cast<int64_t>(DecimalP(std::string("-123456123456.12345678987654321112345676445342323423")))), 1097928128);
+  ASSERT_EQ((calc::Cast<int64_t>(DecimalP(std::string("-123456123456.12345678987654321112345676445342323423")))), INT64_C(-123456123456));
 
   //float and double should not be compared by operator =.
   ASSERT_EQ((calc::Cast<float>(DecimalP(std::string("123456.123456789")))), 123456.125);
@@ -0,0 +1,246 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../exception.h"
+#include "casting.h"
+#include "kernels.h"
+#include "mathematic.h"
+
+using namespace dingodb::expr;
+using namespace dingodb::expr::calc;
+
+// Not a multiple of any number of lanes, to cover the tails.
+static constexpr size_t SIZE = 39;
+
+template <typename T>
+static std::vector<T> MakeValues(unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(-5, 5);
+  std::vector<T> values(SIZE);
+  for (auto &v : values) {
+    v = static_cast<T>(dist(gen));
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    values[3] = std::numeric_limits<T>::quiet_NaN();
+    values[10] = std::numeric_limits<T>::quiet_NaN();
+  }
+  return values;
+}
+
+template <typename T, bool (*Calc)(T, T)>
+static void CheckCmp(KernelOp op) {
+  auto v0 = MakeValues<T>(1);
+  auto v1 = MakeValues<T>(2);
+  bool expected[SIZE];
+  for (size_t i = 0; i < SIZE; ++i) {
+    expected[i] = Calc(v0[i], v1[i]);
+  }
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    bool out[SIZE];
+    ASSERT_TRUE((GetKernel<bool, T>(op, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      ASSERT_EQ(out[i], expected[i]) << "level = " << level << ", i = " << i;
+    }
+    ASSERT_TRUE((GetConstKernel<bool, T>(op, KernelLevel(level))(v0.data(), v1[0], out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      ASSERT_EQ(out[i], Calc(v0[i], v1[0])) << "level = " << level << ", i = " << i;
+    }
+  }
+}
+
+template <typename T, T (*Calc)(T, T)>
+static void CheckArith(KernelOp op) {
+  auto v0 = MakeValues<T>(3);
+  auto v1 = MakeValues<T>(4);
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    T out[SIZE];
+    ASSERT_TRUE((GetKernel<T, T>(op, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      auto expected = Calc(v0[i], v1[i]);
+      if (std::isnan(static_cast<double>(expected))) {
+        ASSERT_TRUE(std::isnan(static_cast<double>(out[i])));
+      } else {
+        ASSERT_EQ(out[i], expected) << "level = " << level << ", i = " << i;
+      }
+    }
+    ASSERT_TRUE((GetConstKernel<T, T>(op, KernelLevel(level))(v0.data(), v1[1], out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      auto expected = Calc(v0[i], v1[1]);
+      if (std::isnan(static_cast<double>(expected))) {
+        ASSERT_TRUE(std::isnan(static_cast<double>(out[i])));
+      } else {
+        ASSERT_EQ(out[i], expected) << "level = " << level << ", i = " << i;
+      }
+    }
+  }
+}
+
+template <typename T>
+static void CheckAll() {
+  CheckCmp<T, Eq<T>>(KERNEL_EQ);
+  CheckCmp<T, Ne<T>>(KERNEL_NE);
+  CheckCmp<T, Lt<T>>(KERNEL_LT);
+  CheckCmp<T, Le<T>>(KERNEL_LE);
+  CheckCmp<T, Gt<T>>(KERNEL_GT);
+  CheckCmp<T, Ge<T>>(KERNEL_GE);
+  CheckArith<T, Add<T>>(KERNEL_ADD);
+  CheckArith<T, Sub<T>>(KERNEL_SUB);
+  CheckArith<T, Mul<T>>(KERNEL_MUL);
+}
+
+TEST(TestKernels, Int32) {
+  CheckAll<int32_t>();
+}
+
+TEST(TestKernels, Int64) {
+  CheckAll<int64_t>();
+}
+
+TEST(TestKernels, Float) {
+  CheckAll<float>();
+}
+
+TEST(TestKernels, Double) {
+  CheckAll<double>();
+}
+
+TEST(TestKernels, OpOf) {
+  ASSERT_EQ((KernelOpOf<bool, int32_t, int32_t, Lt<int32_t>>()), KERNEL_LT);
+  ASSERT_EQ((KernelOpOf<double, double, double, Mul<double>>()), KERNEL_MUL);
+  ASSERT_EQ((KernelOpOf<int64_t, int64_t, int64_t, Max<int64_t>>()), KERNEL_NONE);
+}
+
+TEST(TestKernels, Overflow) {
+  constexpr auto MAX = std::numeric_limits<int64_t>::max();
+  constexpr auto MIN = std::numeric_limits<int64_t>::min();
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    // Overflow in the vector part and in the tail.
+    for (size_t pos : {0UL, SIZE - 1}) {
+      std::vector<int64_t> v0(SIZE, 1);
+      std::vector<int64_t> v1(SIZE, 1);
+      int64_t out[SIZE];
+      v0[pos] = MAX;
+      ASSERT_FALSE((GetKernel<int64_t, int64_t>(KERNEL_ADD, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+      ASSERT_FALSE((GetConstKernel<int64_t, int64_t>(KERNEL_ADD, KernelLevel(level))(v0.data(), 1, out, SIZE)));
+      ASSERT_FALSE((GetKernel<int64_t, int64_t>(KERNEL_MUL, KernelLevel(level))(v0.data(), v0.data(), out, SIZE)));
+      v0[pos] = MIN;
+      ASSERT_FALSE((GetKernel<int64_t, int64_t>(KERNEL_SUB, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+      ASSERT_TRUE((GetKernel<int64_t, int64_t>(KERNEL_ADD, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+      ASSERT_EQ(out[pos], MIN + 1);
+    }
+    // `int32_t` wraps as the scalar calculation does.
+    std::vector<int32_t> v0(SIZE, std::numeric_limits<int32_t>::max());
+    std::vector<int32_t> v1(SIZE, 1);
+    int32_t out[SIZE];
+    ASSERT_TRUE((GetKernel<int32_t, int32_t>(KERNEL_ADD, KernelLevel(level))(v0.data(), v1.data(), out, SIZE)));
+    ASSERT_EQ(out[0], std::numeric_limits<int32_t>::min());
+    ASSERT_EQ(out[SIZE - 1], std::numeric_limits<int32_t>::min());
+  }
+}
+
+template <typename S>
+static std::array<S, SIZE> MakeCastValues() {
+  std::array<S, SIZE> values;
+  for (size_t i = 0; i < SIZE; ++i) {
+    if constexpr (std::is_same_v<S, bool>) {
+      values[i] = (i % 3 == 0);
+    } else if constexpr (std::is_floating_point_v<S>) {
+      // Halves to round away from zero.
+      values[i] = (static_cast<S>(i) - 20) / 2;
+    } else {
+      values[i] = static_cast<S>(i) * 1000 - 20000;
+    }
+  }
+  return values;
+}
+
+template <typename D, typename S>
+static void CheckCast() {
+  auto in = MakeCastValues<S>();
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    D out[SIZE];
+    ASSERT_TRUE((GetCastKernel<D, S>(KERNEL_CAST, KernelLevel(level))(in.data(), out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      ASSERT_EQ(out[i], (Cast<D, S>(in[i]))) << "level = " << level << ", i = " << i;
+    }
+    ASSERT_TRUE((GetCastKernel<D, S>(KERNEL_CAST_CHECK, KernelLevel(level))(in.data(), out, SIZE)));
+    for (size_t i = 0; i < SIZE; ++i) {
+      ASSERT_EQ(out[i], (CastCheck<D, S>(in[i]))) << "level = " << level << ", i = " << i;
+    }
+  }
+}
+
+template <typename S>
+static void CheckCastFrom() {
+  if constexpr (!std::is_same_v<S, bool>) {
+    CheckCast<bool, S>();
+  }
+  if constexpr (!std::is_same_v<S, int32_t>) {
+    CheckCast<int32_t, S>();
+  }
+  if constexpr (!std::is_same_v<S, int64_t>) {
+    CheckCast<int64_t, S>();
+  }
+  if constexpr (!std::is_same_v<S, float>) {
+    CheckCast<float, S>();
+  }
+  if constexpr (!std::is_same_v<S, double>) {
+    CheckCast<double, S>();
+  }
+}
+
+TEST(TestKernels, Cast) {
+  CheckCastFrom<bool>();
+  CheckCastFrom<int32_t>();
+  CheckCastFrom<int64_t>();
+  CheckCastFrom<float>();
+  CheckCastFrom<double>();
+  ASSERT_EQ((CastKernelOpOf<int32_t, double, Cast<int32_t, double>>()), KERNEL_CAST);
+  ASSERT_EQ((CastKernelOpOf<int32_t, int64_t, CastCheck<int32_t, int64_t>>()), KERNEL_CAST_CHECK);
+  ASSERT_EQ((CastKernelOpOf<int32_t, String, Cast<int32_t, String>>()), KERNEL_NONE);
+}
+
+TEST(TestKernels, CastOutOfRange) {
+  std::vector<double> in(SIZE, 1.5);
+  for (int level = KERNEL_SCALAR; level <= GetKernelLevel(); ++level) {
+    // Out of range in the vector part and in the tail.
+    for (size_t pos : {0UL, SIZE - 1}) {
+      for (double v : {3.0e9, -2147483648.5, std::numeric_limits<double>::quiet_NaN()}) {
+        in[pos] = v;
+        int32_t out[SIZE];
+        ASSERT_FALSE((GetCastKernel<int32_t, double>(KERNEL_CAST_CHECK, KernelLevel(level))(in.data(), out, SIZE)));
+        ASSERT_THROW(CastCheck<int32_t>(v), ExceedsLimits<TYPE_INT32>);
+        // Unchecked casts get what `lround` gets.
+        ASSERT_TRUE((GetCastKernel<int32_t, double>(KERNEL_CAST, KernelLevel(level))(in.data(), out, SIZE)));
+        ASSERT_EQ(out[pos], Cast<int32_t>(v));
+        ASSERT_EQ(out[1], 2);
+        in[pos] = 1.5;
+      }
+    }
+    std::vector<int64_t> big(SIZE, 1);
+    big[SIZE - 1] = std::numeric_limits<int64_t>::min();
+    int32_t out[SIZE];
+    ASSERT_FALSE((GetCastKernel<int32_t, int64_t>(KERNEL_CAST_CHECK, KernelLevel(level))(big.data(), out, SIZE)));
+    ASSERT_TRUE((GetCastKernel<int32_t, int64_t>(KERNEL_CAST, KernelLevel(level))(big.data(), out, SIZE)));
+    ASSERT_EQ(out[SIZE - 1], 0);
+  }
+}
@@ -0,0 +1,260 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "codec.h"
+#include "exception.h"
+#include "runner.h"
+
+using namespace dingodb::expr;
+
+// Rows of (int32, int64, double, bool, string), with nulls scattered.
+static std::vector<Tuple> MakeRows(size_t size) {
+  std::vector<Tuple> rows;
+  for (size_t i = 0; i < size; ++i) {
+    Tuple tuple(5);
+    tuple[0] = (i % 7 == 3) ? Operand(nullptr) : Operand(static_cast<int32_t>(i) - 50);
+    tuple[1] = (i % 11 == 5) ? Operand(nullptr) : Operand(static_cast<int64_t>(i * 3));
+    tuple[2] = (i % 13 == 1) ? Operand(nullptr) : Operand(static_cast<double>(i) / 4);
+    tuple[3] = (i % 5 == 0) ? Operand(nullptr) : Operand(i % 3 == 0);
+    tuple[4] = (i % 9 == 2) ? Operand(nullptr) : Operand(std::make_shared<std::string>(std::to_string(i)));
+    rows.push_back(tuple);
+  }
+  return rows;
+}
+
+static Batch MakeBatch(const std::vector<Tuple> &rows) {
+  static const Byte TYPES[] = {TYPE_INT32, TYPE_INT64, TYPE_DOUBLE, TYPE_BOOL, TYPE_STRING};
+  Batch batch(rows.size());
+  for (size_t j = 0; j < 5; ++j) {
+    auto column = Column::Make(TYPES[j], rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      column.SetOperand(i, rows[i][j]);
+    }
+    batch.AddColumn(column);
+  }
+  return batch;
+}
+
+class BatchTest : public testing::TestWithParam<std::string> {};
+
+TEST_P(BatchTest, RunBatch) {
+  const auto &input = GetParam();
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  // Cross the bounds of the validity words.
+  auto rows = MakeRows(130);
+  auto batch = MakeBatch(rows);
+  runner.RunBatch(&batch);
+  auto column = runner.GetColumn();
+  ASSERT_EQ(column.Size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    runner.BindTuple(&rows[i]);
+    runner.Run();
+    EXPECT_EQ(column.GetOperand(i), runner.Get()) << "row " << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BatchExpr,
+    BatchTest,
+    testing::Values(
+        "1105",                          // 5
+        "01",                            // null
+        "13",                            // true
+        "3100",                          // t0
+        "310011058301",                  // t0 + 5
+        "3100110A8501",                  // t0 * 10
+        "32013100F0218302",              // t1 + int64(t0)
+        "3100F021",                      // int64(t0)
+        "3502F015",                      // int32(t2)
+        "3201F012",                      // int32(t1)
+        "3502F025",                      // int64(t2)
+        "3502FC15",                      // int32_c(t2)
+        "3502F045",                      // float(t2)
+        "3502F035",                      // bool(t2)
+        "3303F013",                      // int32(t3)
+        "3100F071",                      // string(t0)
+        "3100F061",                      // decimal(t0)
+        "3704F017",                      // int32(t4)
+        "35021105F0518305",              // t2 + double(5)
+        "310011038601",                  // t0 / 3
+        "3100B301",                      // abs(t0)
+        "310011009201330352",            // t0 >= 0 && t3
+        "33033100110093015351",          // !(t3 || t0 > 0)
+        "3303A103",                      // is_null(t3)
+        "3303A203",                      // is_true(t3)
+        "3303A303",                      // is_false(t3)
+        "3704370491073704170136950752",  // t4 = t4 && t4 < '6'
+        "310031008301",                  // t0 + t0
+        "320132018502",                  // t1 * t1
+        "35023100F0519505",              // t2 < double(t0)
+        "32013100F0219602",              // t1 <> int64(t0)
+        "31001100B101",                  // min(t0, 0)
+        "3100F0513502B205",              // max(double(t0), t2)
+        "3100110583013100110583018501",   // (t0 + 5) * (t0 + 5)
+        "33033100110583011100930152",     // t3 && t0 + 5 > 0
+        "330331001100930153",             // t3 || t0 > 0
+        "33035131001100930133033100110A9501525352",  // !t3 && (t0 > 0 || t3 && t0 < 10)
+        "3100811101",                                 // sum(t0)
+        "310031001105811103",                         // sum(t0, t0, 5)
+        "3201320132013201811204",                     // sum(t1, t1, t1, t1)
+        "35023201F0523502811503",                     // sum(t2, double(t1), t2)
+        "31001100B11102",                             // min(t0, 0)
+        "3704170135B21702",                           // max(t4, '5')
+        "330331001100930133035403",                   // and(t3, t0 > 0, t3)
+        "33033100110093013100110A95015503",           // or(t3, t0 > 0, t0 < 10)
+        "33035131001100930133033100110A9501525403"  // and(!t3, t0 > 0, t3 && t0 < 10)
+        ));
+
+TEST(BatchTest, GetAllColumns) {
+  // t0, t1 * 2L
+  std::string input = "3100320112028502";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  auto rows = MakeRows(10);
+  auto batch = MakeBatch(rows);
+  runner.RunBatch(&batch);
+  std::unique_ptr<Batch> result(runner.GetAllColumns());
+  ASSERT_EQ(result->ColumnNum(), 2);
+  ASSERT_EQ(result->Size(), 10);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    std::unique_ptr<Tuple> tuple(result->GetTuple(i));
+    EXPECT_EQ((*tuple)[0], rows[i][0]);
+    if (rows[i][1] != nullptr) {
+      EXPECT_EQ((*tuple)[1], Operand(rows[i][1].GetValue<int64_t>() * 2));
+    } else {
+      EXPECT_EQ((*tuple)[1], nullptr);
+    }
+  }
+}
+
+TEST(BatchTest, OverflowOfNulls) {
+  // t0 + 1L
+  std::string input = "320012018302";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  auto make_batch = [](bool null) {
+    auto column = Column::Make<int64_t>(TYPE_INT64, 10);
+    for (size_t i = 0; i < 10; ++i) {
+      column.Set<int64_t>(i, static_cast<int64_t>(i));
+    }
+    column.Set<int64_t>(7, std::numeric_limits<int64_t>::max());
+    if (null) {
+      column.SetNull(7);
+    }
+    Batch batch(10);
+    batch.AddColumn(column);
+    return batch;
+  };
+  // The overflow of a null row is not an error.
+  auto batch = make_batch(true);
+  runner.RunBatch(&batch);
+  auto result = runner.GetColumn();
+  for (size_t i = 0; i < 10; ++i) {
+    if (i == 7) {
+      EXPECT_EQ(result.GetOperand(i), nullptr);
+    } else {
+      EXPECT_EQ(result.GetOperand(i), Operand(static_cast<int64_t>(i + 1)));
+    }
+  }
+  auto overflow = make_batch(false);
+  ASSERT_THROW(runner.RunBatch(&overflow), ExceedsLimits<TYPE_INT64>);
+  // Or get the error without throwing.
+  auto error = runner.TryRunBatch(&overflow);
+  ASSERT_NE(error, nullptr);
+  ASSERT_THROW(std::rethrow_exception(error), ExceedsLimits<TYPE_INT64>);
+  ASSERT_EQ(runner.TryRunBatch(&batch), nullptr);
+}
+
+TEST(BatchTest, OverflowOfMul) {
+  // t0 * t0 + 1L
+  std::string input = "32003200850212018302";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  auto column = Column::Make<int64_t>(TYPE_INT64, 100);
+  for (size_t i = 0; i < 100; ++i) {
+    column.Set<int64_t>(i, static_cast<int64_t>(i) << 31);
+  }
+  Batch batch(100);
+  batch.AddColumn(column);
+  auto error = runner.TryRunBatch(&batch);
+  ASSERT_NE(error, nullptr);
+  ASSERT_THROW(std::rethrow_exception(error), ExceedsLimits<TYPE_INT64>);
+}
+
+TEST(BatchTest, CastCheckOfNulls) {
+  // int32_c(t0)
+  std::string input = "3200FC12";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  auto column = Column::Make<int64_t>(TYPE_INT64, 10);
+  for (size_t i = 0; i < 10; ++i) {
+    column.Set<int64_t>(i, -static_cast<int64_t>(i));
+  }
+  column.Set<int64_t>(7, std::numeric_limits<int64_t>::max());
+  column.SetNull(7);
+  Batch batch(10);
+  batch.AddColumn(column);
+  // Out of range of a null row is not an error.
+  runner.RunBatch(&batch);
+  auto result = runner.GetColumn();
+  ASSERT_EQ(result.GetOperand(7), nullptr);
+  ASSERT_EQ(result.GetOperand(9), Operand(-9));
+  // The column shares the values and validity with the batch.
+  column.Set<int64_t>(7, std::numeric_limits<int64_t>::max());
+  ASSERT_THROW(runner.RunBatch(&batch), ExceedsLimits<TYPE_INT32>);
+}
+
+TEST(BatchTest, CheckBatch) {
+  // t0 + 1L
+  std::string input = "320012018302";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  // Checked once for the batch, instead of reading the values of other types.
+  Batch batch(10);
+  batch.AddColumn(Column::Make<int32_t>(TYPE_INT32, 10));
+  ASSERT_THROW(runner.RunBatch(&batch), ExprError);
+  Batch empty(10);
+  ASSERT_THROW(runner.RunBatch(&empty), ExprError);
+  Batch dates(10);
+  dates.AddColumn(Column::Make<int64_t>(TYPE_DATE, 10));
+  runner.RunBatch(&dates);
+  ASSERT_EQ(runner.GetColumn().GetOperand(0), nullptr);
+}
@@ -19,7 +19,10 @@
 #include <tuple>
 
 #include "codec.h"
+#include "exception.h"
+#include "operator_vector.h"
 #include "runner.h"
+#include "vm_runner.h"
 
 using namespace dingodb::expr;
 
@@ -39,6 +42,20 @@ TEST_P(ExprTest, Run) {
   EXPECT_EQ(result, std::get<2>(para));
 }
 
+TEST_P(ExprTest, RunVm) {
+  const auto &para = GetParam();
+  VmRunner runner;
+  auto input = std::get<0>(para);
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  runner.Decode(buf, len);
+  runner.BindTuple(std::get<1>(para));
+  runner.Run();
+  auto result = runner.Get();
+  EXPECT_EQ(result, std::get<2>(para));
+}
+
 // Test cases with consts
 INSTANTIATE_TEST_SUITE_P(
     ConstExpr,
@@ -67,7 +84,13 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple("130352", nullptr, nullptr),                            // true && null
         std::make_tuple("01A101", nullptr, true),                               // is_null(null)
         std::make_tuple("1101A201", nullptr, true),                             // is_true(1)
-        std::make_tuple("218080808008B301", nullptr, INT_MIN)                   // abs(-INT32_MAX)
+        std::make_tuple("218080808008B301", nullptr, INT_MIN),                  // abs(-INT32_MAX)
+        std::make_tuple("110111021103811103", nullptr, 6),                      // sum(1, 2, 3)
+        std::make_tuple("1101011102811103", nullptr, nullptr),                  // sum(1, null, 2)
+        std::make_tuple("1703616263170162170161B21703", nullptr, "b"),          // max('abc', 'b', 'a')
+        std::make_tuple("1303135403", nullptr, nullptr),                        // and(true, null, true)
+        std::make_tuple("0323135403", nullptr, false),                          // and(null, false, true)
+        std::make_tuple("2313035503", nullptr, true)                            // or(false, true, null)
         ));
 
 static Tuple tuple1{1, 2};
@@ -242,5 +265,339 @@ INSTANTIATE_TEST_SUITE_P(
         // is_false(TIMESTAMP(v))
         std::make_tuple("3901A30900", &tuple7, false),
         // is_false(TIMESTAMP(null))
-        std::make_tuple("3901A30900", &tuple9, false)
+        std::make_tuple("3901A30900", &tuple9, false),
+
+        // sum(t0, t1, t0)
+        std::make_tuple("310031013100811103", &tuple1, 4),
+        // sum(t0, t1)
+        std::make_tuple("32003201811202", &tuple2, 81LL),
+        // min(t0, t1, 3.0)
+        std::make_tuple("35003501154008000000000000B11503", &tuple3, 3.0),
+        // max(t0, t1)
+        std::make_tuple("37003701B21702", &tuple4, "abc")
+        ));
+
+TEST(OperatorVectorTest, MaxDepth) {
+  // t0 + t1 * t2, 1
+  std::string input = "310031013102850183011101";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(operator_vector.GetMaxDepth(), 3);
+  EXPECT_EQ(operator_vector.GetResultNum(), 2);
+}
+
+TEST(OperatorVectorTest, NotEnoughOperands) {
+  // 3 +
+  std::string input = "11038301";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  EXPECT_THROW(operator_vector.Decode(buf, len), ExprError);
+}
+
+TEST(OperatorVectorTest, OutOfBounds) {
+  const char *inputs[] = {
+      "31",                    // t? without the index
+      "11",                    // INT32 without the value
+      "11FFFFFFFFFFFF01",      // INT32 of a varint too long
+      "143F80",                // FLOAT of 2 bytes
+      "17036162",              // STRING of length 3 but 2 bytes
+      "2600",                  // DECIMAL without the length
+      "3100310083",            // t0 + t0, without the type
+      "31003100830A",          // t0 + t0, of type 10
+      "3100F0FF",              // CAST of type 15
+      "FF",                    // unknown code
+      "5400",                  // AND_FUN of no operand
+      "13135403",              // AND_FUN of 3 operands, but 2
+      "3100811701",            // SUM of STRING
+      "3100B111",              // VARG_MIN without the arity
+  };
+  for (const auto *input : inputs) {
+    std::string hex(input);
+    auto len = hex.size() / 2;
+    Byte buf[len];
+    HexToBytes(buf, hex.data(), hex.size());
+    OperatorVector operator_vector;
+    EXPECT_THROW(operator_vector.Decode(buf, len), ExprError) << input;
+  }
+}
+
+TEST(OperatorVectorTest, DecodeAgain) {
+  // t0 + 1, 'abc'
+  std::string input0 = "3100110183011703616263";
+  // t0 * 2
+  std::string input1 = "310011028501";
+  Byte buf0[input0.size() / 2];
+  Byte buf1[input1.size() / 2];
+  HexToBytes(buf0, input0.data(), input0.size());
+  HexToBytes(buf1, input1.data(), input1.size());
+  // The operators of the last expression are destroyed and their memory reused.
+  Runner runner;
+  Tuple tuple{3};
+  for (int i = 0; i < 3; ++i) {
+    runner.Decode(buf0, sizeof(buf0));
+    runner.BindTuple(&tuple);
+    runner.Run();
+    std::unique_ptr<Tuple> result(runner.GetAll());
+    EXPECT_EQ(*result, (Tuple{4, Operand("abc")}));
+    runner.Decode(buf1, sizeof(buf1));
+    runner.BindTuple(&tuple);
+    runner.Run();
+    EXPECT_EQ(runner.Get(), Operand(6));
+  }
+}
+
+TEST(OperatorVectorTest, IllTyped) {
+  const char *inputs[] = {
+      "310011018302",        // int32 t0 + int32 1, of type INT64
+      "310051",              // !int32 t0
+      "3100330052",          // int32 t0 && t0
+      "310011018301330051",  // int32 t0 + 1, !bool t0
+      "1703616263F101",      // ceil('abc')
+  };
+  for (const auto *input : inputs) {
+    std::string hex(input);
+    auto len = hex.size() / 2;
+    Byte buf[len];
+    HexToBytes(buf, hex.data(), hex.size());
+    OperatorVector operator_vector;
+    EXPECT_THROW(operator_vector.Decode(buf, len), ExprError) << input;
+  }
+}
+
+TEST(OperatorVectorTest, VarTypes) {
+  // t0 + 1, t2, bool t1 || NULL_INT32
+  std::string input = "31001101830135023301015300";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  // The variable only passed through is of any type.
+  EXPECT_EQ(operator_vector.GetVarTypes(), (std::vector<Byte>{TYPE_INT32, TYPE_BOOL, TYPE_NULL}));
+  EXPECT_EQ(operator_vector.GetResultNum(), 3);
+}
+
+TEST(OperatorVectorTest, CheckTuple) {
+  // t0 + 1
+  std::string input = "310011018301";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  VmRunner vm_runner;
+  vm_runner.Decode(buf, len);
+  Tuple tuples[] = {{}, {1LL}, {"abc"}};
+  for (const auto &tuple : tuples) {
+    runner.BindTuple(&tuple);
+    EXPECT_THROW(runner.Run(), ExprError);
+    vm_runner.BindTuple(&tuple);
+    EXPECT_THROW(vm_runner.Run(), ExprError);
+  }
+  EXPECT_THROW(Runner(runner.GetProgram()).Run(), ExprError);
+  Tuple tuple{nullptr, 2};
+  runner.BindTuple(&tuple);
+  runner.Run();
+  EXPECT_EQ(runner.Get(), nullptr);
+  // Variables passed through must be there as well.
+  HexToBytes(buf, "3302", 4);
+  runner.Decode(buf, 2);
+  Tuple short_tuple{1, 2LL};
+  runner.BindTuple(&short_tuple);
+  EXPECT_THROW(runner.Run(), ExprError);
+}
+
+class OptimizeTest : public testing::TestWithParam<std::tuple<std::string, Tuple *, size_t, Operand>> {};
+
+TEST_P(OptimizeTest, Optimize) {
+  const auto &para = GetParam();
+  auto input = std::get<0>(para);
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(std::distance(operator_vector.begin(), operator_vector.end()), std::get<2>(para));
+  Runner runner;
+  runner.Decode(buf, len);
+  runner.BindTuple(std::get<1>(para));
+  runner.Run();
+  EXPECT_EQ(runner.Get(), std::get<3>(para));
+}
+
+static Tuple tupleBool1{true, nullptr};
+
+INSTANTIATE_TEST_SUITE_P(
+    OptimizeExpr,
+    OptimizeTest,
+    testing::Values(
+        std::make_tuple("11031104110685018301", nullptr, 1, 27),            // 3 + 4 * 6
+        std::make_tuple("3100110311048501830100", &tuple1, 1, 13),        // t0 + 3 * 4, folded and fused
+        std::make_tuple("110111008601", nullptr, 1, nullptr),               // 1 / 0
+        std::make_tuple("1704312E3235F067F076", nullptr, 1, "1.25"),        // str(decimal('1.25'))
+        std::make_tuple("33001352", &tupleBool1, 1, true),                  // t0 && true
+        std::make_tuple("13330152", &tupleBool1, 1, nullptr),               // true && t1
+        std::make_tuple("33002353", &tupleBool1, 1, true),                  // t0 || false
+        std::make_tuple("23330153", &tupleBool1, 1, nullptr),               // false || t1
+        std::make_tuple("330051515151", &tupleBool1, 1, true),              // !!!!t0
+        std::make_tuple("3300515151", &tupleBool1, 2, false),               // !!!t0
+        std::make_tuple("33002352", &tupleBool1, 3, false),                 // t0 && false, not simplified
+        std::make_tuple("3300130153", &tupleBool1, 2, true)                 // t0 || (true && true)
+        ));
+
+TEST(OptimizeTest, NotFoldingErrors) {
+  // check_int32(-4294967295L)
+  std::string input = "22FFFFFFFF0FFC12";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(std::distance(operator_vector.begin(), operator_vector.end()), 2);
+  Runner runner;
+  runner.Decode(buf, len);
+  EXPECT_THROW(runner.Run(), ExprError);
+}
+
+class CseTest : public testing::TestWithParam<std::tuple<std::string, Tuple *, size_t, Tuple>> {};
+
+TEST_P(CseTest, Run) {
+  const auto &para = GetParam();
+  auto input = std::get<0>(para);
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(std::distance(operator_vector.begin(), operator_vector.end()), std::get<2>(para));
+  Runner runner;
+  runner.Decode(buf, len);
+  runner.BindTuple(std::get<1>(para));
+  runner.Run();
+  std::unique_ptr<Tuple> result(runner.GetAll());
+  EXPECT_EQ(*result, std::get<3>(para));
+  VmRunner vm_runner;
+  vm_runner.Decode(buf, len);
+  vm_runner.BindTuple(std::get<1>(para));
+  vm_runner.Run();
+  std::unique_ptr<Tuple> vm_result(vm_runner.GetAll());
+  EXPECT_EQ(*vm_result, std::get<3>(para));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CseExpr,
+    CseTest,
+    testing::Values(
+        // double(decimal(t0) + decimal(t0))
+        std::make_tuple("3100F0613100F0618306F056", &tuple1, 6, Tuple{2.0}),
+        // t0 * t1 > 0 && t0 * t1 < 10
+        std::make_tuple("31003101850111009301310031018501110A950152", &tuple1, 11, Tuple{true}),
+        // (t0 + t1) * (t0 + t1), t0 + t1, t0
+        std::make_tuple("31003101830131003101830185013100310183013100", &tuple1, 8, Tuple{9, 3, 1}),
+        // ((t0 + t1) * 2) + ((t0 + t1) * 2), t1 + t0
+        std::make_tuple(
+            "3100310183011102850131003101830111028501830131013100830100", &tuple1, 11, Tuple{12, 3}
+        ),
+        // (t0 + 5) * (t0 + 5), both fused as a variable and a constant
+        std::make_tuple("3100110583013100110583018501", &tuple1, 4, Tuple{36}),
+        // t0 + 1, t1 + 1, no common sub-expressions
+        std::make_tuple("310011018301310111018301", &tuple1, 2, Tuple{2, 3})
+        ));
+
+class ShortCircuitTest : public testing::TestWithParam<std::tuple<std::string, size_t, Operand>> {};
+
+static Tuple tupleShortCircuit{true, false, nullptr, INT64_C(4294967296)};
+
+TEST_P(ShortCircuitTest, Run) {
+  const auto &para = GetParam();
+  auto input = std::get<0>(para);
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(std::distance(operator_vector.begin(), operator_vector.end()), std::get<1>(para));
+  Runner runner;
+  runner.Decode(buf, len);
+  runner.BindTuple(&tupleShortCircuit);
+  runner.Run();
+  EXPECT_EQ(runner.Get(), std::get<2>(para));
+  VmRunner vm_runner;
+  vm_runner.Decode(buf, len);
+  vm_runner.BindTuple(&tupleShortCircuit);
+  vm_runner.Run();
+  EXPECT_EQ(vm_runner.Get(), std::get<2>(para));
+}
+
+// `check_int32(t3)` throws, so the cases pass only if it is skipped.
+INSTANTIATE_TEST_SUITE_P(
+    ShortCircuitExpr,
+    ShortCircuitTest,
+    testing::Values(
+        std::make_tuple("33013203FC121100930152", 7, false),              // t1 && check_int32(t3) > 0
+        std::make_tuple("33003203FC121100930153", 7, true),               // t0 || check_int32(t3) > 0
+        std::make_tuple("330233013203FC12110093015252", 10, false),       // t2 && (t1 && check_int32(t3) > 0)
+        std::make_tuple("330233003203FC12110093015353", 10, true),        // t2 || (t0 || check_int32(t3) > 0)
+        std::make_tuple("3300330133025352", 6, nullptr),                  // t0 && (t1 || t2)
+        std::make_tuple("3302330053", 3, true),                           // t2 || t0, not worth jumping
+        std::make_tuple("330033013203FC12110093015403", 9, false),        // and(t0, t1, check_int32(t3) > 0)
+        std::make_tuple("3301330233003203FC12110093015504", 11, true),    // or(t1, t2, t0, check_int32(t3) > 0)
+        std::make_tuple("3300330233005403", 5, nullptr),                  // and(t0, t2, t0)
+        std::make_tuple("3302330133005503", 5, true)                      // or(t2, t1, t0)
+        ));
+
+TEST(ShortCircuitTest, NotSkipped) {
+  // t0 && check_int32(t3) > 0
+  std::string input = "33003203FC121100930152";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  runner.Decode(buf, len);
+  runner.BindTuple(&tupleShortCircuit);
+  EXPECT_THROW(runner.Run(), ExprError);
+  VmRunner vm_runner;
+  vm_runner.Decode(buf, len);
+  vm_runner.BindTuple(&tupleShortCircuit);
+  EXPECT_THROW(vm_runner.Run(), ExprError);
+}
+
+class FuseTest : public testing::TestWithParam<std::tuple<std::string, Tuple *, size_t, Operand>> {};
+
+TEST_P(FuseTest, Run) {
+  const auto &para = GetParam();
+  auto input = std::get<0>(para);
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  OperatorVector operator_vector;
+  operator_vector.Decode(buf, len);
+  EXPECT_EQ(std::distance(operator_vector.begin(), operator_vector.end()), std::get<2>(para));
+  Runner runner;
+  runner.Decode(buf, len);
+  runner.BindTuple(std::get<1>(para));
+  runner.Run();
+  EXPECT_EQ(runner.Get(), std::get<3>(para));
+  VmRunner vm_runner;
+  vm_runner.Decode(buf, len);
+  vm_runner.BindTuple(std::get<1>(para));
+  vm_runner.Run();
+  EXPECT_EQ(vm_runner.Get(), std::get<3>(para));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FuseExpr,
+    FuseTest,
+    testing::Values(
+        std::make_tuple("310011009301", &tuple1, 1, true),                      // t0 > 0
+        std::make_tuple("320112058302", &tuple2, 1, 51LL),                      // t1 + 5L
+        std::make_tuple("35001540100000000000009505", &tuple3, 1, true),        // t0 < 4.0
+        std::make_tuple("370017036162639107", &tuple4, 1, true),                // t0 = 'abc'
+        std::make_tuple("310211009301", &tuple6, 1, nullptr),                   // t2 > 0
+        std::make_tuple("110031009301", &tuple1, 3, false)                      // 0 > t0, not fused
         ));
@@ -107,5 +107,23 @@ INSTANTIATE_TEST_SUITE_P(
         //CONST | DECIMAL, POS.
         std::make_tuple("16073132332E313233", nullptr, "123.123"),
         //CONST | DECIMAL, NEG.
-        std::make_tuple("16082D3132332E313233", nullptr, "-123.123")
-    ));
\ No newline at end of file
+        std::make_tuple("16082D3132332E313233", nullptr, "-123.123"),
+        //CONST_N | DECIMAL, binary form of 12.34.
+        std::make_tuple("26020204D2", nullptr, "12.34"),
+        //CONST_N | DECIMAL, binary form of -123.123.
+        std::make_tuple("260303FE1F0D", nullptr, "-123.123"),
+        //Binary form + text form.
+        std::make_tuple("26020204D2160531322E33348306", nullptr, "24.68"),
+        //Binary form of 10^20 * binary form of 10^-20.
+        std::make_tuple("260009056BC75E2D63100000261401018506", nullptr, "1")
+    ));
+
+TEST(ExprDecimalBinaryTest, InvalidScale) {
+  // Scale 39 is more than the max.
+  std::string input = "26270101";
+  auto len = input.size() / 2;
+  Byte buf[len];
+  HexToBytes(buf, input.data(), input.size());
+  Runner runner;
+  EXPECT_THROW(runner.Decode(buf, len), ExprError);
+}
\ No newline at end of file
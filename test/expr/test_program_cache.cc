@@ -0,0 +1,173 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch.h"
+#include "codec.h"
+#include "execution_context.h"
+#include "program_cache.h"
+#include "runner.h"
+
+using namespace dingodb::expr;
+
+static std::vector<Byte> ToBytes(const std::string &hex) {
+  std::vector<Byte> buf(hex.size() / 2);
+  HexToBytes(buf.data(), hex.data(), hex.size());
+  return buf;
+}
+
+TEST(ProgramCacheTest, HitAndMiss) {
+  ProgramCache cache(16, 1);
+  // 3 + 4, then the trailing bytes of the next expression
+  auto code = ToBytes("11031104830100FF");
+  std::shared_ptr<const Program> p0;
+  std::shared_ptr<const Program> p1;
+  const auto *end0 = cache.Decode(p0, code.data(), code.size());
+  const auto *end1 = cache.Decode(p1, code.data(), code.size());
+  EXPECT_EQ(end0, code.data() + 7);
+  EXPECT_EQ(end1, end0);
+  EXPECT_EQ(p0, p1);
+  EXPECT_EQ(cache.GetHits(), 1);
+  EXPECT_EQ(cache.GetMisses(), 1);
+  // Same bytes at a different address.
+  auto copy = code;
+  std::shared_ptr<const Program> p2;
+  cache.Decode(p2, copy.data(), copy.size());
+  EXPECT_EQ(p2, p0);
+  EXPECT_EQ(cache.GetHits(), 2);
+}
+
+TEST(ProgramCacheTest, Evict) {
+  ProgramCache cache(2, 1);
+  auto c0 = ToBytes("1101");
+  auto c1 = ToBytes("1102");
+  auto c2 = ToBytes("1103");
+  std::shared_ptr<const Program> p;
+  cache.Decode(p, c0.data(), c0.size());
+  cache.Decode(p, c1.data(), c1.size());
+  // Make c0 the most recently used.
+  cache.Decode(p, c0.data(), c0.size());
+  cache.Decode(p, c2.data(), c2.size());
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.GetHits(), 1);
+  cache.Decode(p, c0.data(), c0.size());
+  EXPECT_EQ(cache.GetHits(), 2);
+  cache.Decode(p, c1.data(), c1.size());
+  EXPECT_EQ(cache.GetHits(), 2);
+  EXPECT_EQ(cache.GetMisses(), 4);
+}
+
+TEST(ProgramCacheTest, Concurrent) {
+  ProgramCache cache(8);
+  std::vector<std::vector<Byte>> codes;
+  for (int i = 0; i < 32; ++i) {
+    // i + (i + 1)
+    char hex[16];
+    snprintf(hex, sizeof(hex), "11%02X11%02X8301", i, i + 1);
+    codes.push_back(ToBytes(hex));
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &codes]() {
+      for (int k = 0; k < 200; ++k) {
+        const auto &code = codes[k % codes.size()];
+        std::shared_ptr<const Program> p;
+        cache.Decode(p, code.data(), code.size());
+        EXPECT_EQ(p->GetResultNum(), 1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(cache.GetHits() + cache.GetMisses(), 800);
+}
+
+TEST(ProgramCacheTest, RunnersShareProgram) {
+  auto code = ToBytes("110511068301");
+  auto hits = ProgramCache::Instance().GetHits();
+  Runner r0;
+  Runner r1;
+  r0.Decode(code.data(), code.size());
+  r1.Decode(code.data(), code.size());
+  EXPECT_GT(ProgramCache::Instance().GetHits(), hits);
+  r0.Run();
+  r1.Run();
+  EXPECT_EQ(r0.Get(), 11);
+  EXPECT_EQ(r1.Get(), 11);
+}
+
+TEST(ProgramTest, ConcurrentRun) {
+  // t0 * 2 + 1
+  auto code = ToBytes("3100110285011101830100");
+  auto program = std::make_shared<Program>();
+  program->Decode(code.data(), code.size());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([program, t]() {
+      ExecutionContext context(*program);
+      for (int i = 0; i < 1000; ++i) {
+        Tuple tuple{t * 1000 + i};
+        context.BindTuple(&tuple);
+        program->Run(context);
+        EXPECT_EQ(context.Get(), (t * 1000 + i) * 2 + 1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(ProgramTest, RunnerOfProgram) {
+  auto code = ToBytes("3100110A8301");
+  Runner r0;
+  r0.Decode(code.data(), code.size());
+  Runner r1(r0.GetProgram());
+  Tuple t0{1};
+  Tuple t1{2};
+  r0.BindTuple(&t0);
+  r1.BindTuple(&t1);
+  r0.Run();
+  r1.Run();
+  EXPECT_EQ(r0.Get(), 11);
+  EXPECT_EQ(r1.Get(), 12);
+}
+
+TEST(ProgramTest, UnpreparedContext) {
+  // double(decimal(t0) + decimal(t0)), with the cast saved to a temporary slot
+  auto code = ToBytes("3100F0613100F0618306F056");
+  Program program;
+  program.Decode(code.data(), code.size());
+  ASSERT_GT(program.GetTempNum(), 0);
+  ExecutionContext context;
+  Tuple tuple{3};
+  context.BindTuple(&tuple);
+  program.Run(context);
+  EXPECT_EQ(context.Get(), 6.0);
+  ExecutionContext batch_context;
+  Batch batch(1);
+  auto column = Column::Make(TYPE_INT32, 1);
+  column.SetOperand(0, 3);
+  batch.AddColumn(column);
+  program.RunBatch(batch_context, &batch);
+  EXPECT_EQ(batch_context.GetColumn().GetOperand(0), 6.0);
+}
@@ -15,7 +15,12 @@
 #include <gtest/gtest.h>
 
 #include <functional>
+#include <memory>
+#include <string>
+#include <variant>
 
+#include "expr/calc/string_fun.h"
+#include "expr/operand.h"
 #include "expr/types.h"
 
 using namespace dingodb::expr;
@@ -23,10 +28,106 @@ using namespace dingodb::expr;
 TEST(TestTypes, StringEquals) {
   String s0{"Alice"};
   String s1{"Alice"};
-  ASSERT_EQ(std::hash<std::string>()(*s0), std::hash<std::string>()(*s1));
+  ASSERT_EQ(std::hash<std::string_view>()(*s0), std::hash<std::string_view>()(*s1));
   ASSERT_TRUE(std::equal_to()(*s0, *s1));
   ASSERT_EQ(*s0, *s1);
   ASSERT_EQ(std::hash<String>()(s0), std::hash<String>()(s1));
   ASSERT_TRUE(std::equal_to()(s0, s1));
   ASSERT_EQ(s0, s1);
 }
+
+TEST(TestTypes, StringSlices) {
+  String s0{"Hello, world and all the rest"};
+  auto s1 = s0.Slice(7, 5);
+  ASSERT_EQ(*s1, "world");
+  // Share the characters.
+  ASSERT_EQ(s1->data(), s0->data() + 7);
+  ASSERT_EQ(s0.GetPtr(), s0.GetPtr());
+  ASSERT_EQ(*s1.GetPtr(), "world");
+  ASSERT_EQ(s1, String("world"));
+  ASSERT_EQ(std::hash<String>()(s1), std::hash<String>()(String("world")));
+}
+
+TEST(TestTypes, StringSmall) {
+  String s0{"Hello, world"};
+  auto s1 = s0.Slice(7);
+  ASSERT_EQ(*s1, "world");
+  // Inline characters are copied with the string.
+  ASSERT_NE(s1->data(), s0->data() + 7);
+  String s2;
+  {
+    String s3{"Hello"};
+    s2 = s3;
+  }
+  ASSERT_EQ(*s2, "Hello");
+  ASSERT_EQ(*String(std::move(s1)), "world");
+  ASSERT_EQ(*Operand("Alice").GetValue<String>(), "Alice");
+  ASSERT_EQ(Operand(String("Alice")), Operand("Alice"));
+}
+
+TEST(TestTypes, StringFunSlices) {
+  String s{"  Hello, world and all the rest  "};
+  ASSERT_EQ(calc::Trim(s)->data(), s->data() + 2);
+  ASSERT_EQ(*calc::Left(calc::Trim(s), 5), "Hello");
+  ASSERT_EQ(calc::Right(s, 7)->data(), s->data() + 26);
+  ASSERT_EQ(*calc::Mid(s, 3, 5), "Hello");
+  ASSERT_EQ(*calc::Substr(s, 2, 7), "Hello");
+}
+
+TEST(TestTypes, StringViews) {
+  std::string buf{"owned by the caller"};
+  auto s0 = String::View(buf);
+  ASSERT_EQ(s0->data(), buf.data());
+  ASSERT_EQ(*s0.Slice(0, 5), "owned");
+  Operand v(s0);
+  ASSERT_EQ(v.GetStringView().data(), buf.data());
+  ASSERT_EQ(*String().GetPtr(), "");
+}
+
+TEST(TestTypes, OperandSize) {
+  ASSERT_EQ(sizeof(Operand), 16);
+}
+
+TEST(TestTypes, OperandScalars) {
+  Operand v0(1);
+  Operand v1(INT64_C(1));
+  Operand v2(1.5);
+  ASSERT_TRUE(v0.Is<int32_t>());
+  ASSERT_TRUE(v1.Is<int64_t>());
+  ASSERT_NE(v0, v1);
+  ASSERT_EQ(v2.GetValue<double>(), 1.5);
+  ASSERT_THROW(v2.GetValue<float>(), std::bad_variant_access);
+  ASSERT_EQ(Operand(), nullptr);
+  ASSERT_NE(v0, nullptr);
+}
+
+TEST(TestTypes, OperandStrings) {
+  // Inline, boxed from characters and boxed from a `String`.
+  Operand v0("Alice");
+  Operand v1("A string too long to be inline");
+  Operand v2(String("Alice"));
+  ASSERT_TRUE(v0.Is<String>());
+  ASSERT_TRUE(v2.Is<String>());
+  ASSERT_EQ(v0, v2);
+  ASSERT_EQ(std::hash<Operand>()(v0), std::hash<Operand>()(v2));
+  ASSERT_EQ(*v0.GetValue<String>(), "Alice");
+  ASSERT_EQ(v1.GetStringView(), "A string too long to be inline");
+  ASSERT_EQ(Operand(""), Operand(String("")));
+  ASSERT_EQ(Operand("12345678901234").GetStringView(), "12345678901234");
+}
+
+TEST(TestTypes, OperandCopies) {
+  auto ptr = std::make_shared<std::string>("A string too long to be inline");
+  {
+    Operand v0(ptr);
+    Operand v1 = v0;
+    Operand v2;
+    v2 = v1;
+    Operand v3 = std::move(v1);
+    ASSERT_EQ(v1, nullptr);  // NOLINT(bugprone-use-after-move)
+    ASSERT_EQ(v2, v3);
+    v3 = v3;
+    ASSERT_EQ(v3.GetValue<String>().GetPtr(), ptr);
+  }
+  ASSERT_EQ(ptr.use_count(), 1);
+}
@@ -14,9 +14,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "expr/batch.h"
 #include "expr/codec.h"
+#include "rel/op/grouped_agg_op.h"
 #include "rel/rel_runner.h"
 
 using namespace dingodb::expr;
@@ -73,6 +80,16 @@ static Data MakeDataForCountDecimal() {
 };
 }
 
+static Data MakeDataForGroupDecimal() {
+  return Data{
+    new Tuple{1, "1.50"},
+    new Tuple{2, "1.5"},
+    new Tuple{3, "2"},
+    new Tuple{4, "1.500"},
+    new Tuple{5, "2.00"},
+};
+}
+
 static Data MakeDataForInstr() {
   return Data{
     new Tuple{"abcdef"},
@@ -196,7 +213,7 @@ INSTANTIATE_TEST_SUITE_P(
                 new Tuple{1, "Alice", 1.2345678f},
             },
             Data{
-                new Tuple{"1.234567761421204"},
+                new Tuple{"1.2345678"},
             }
         ),
         // PROJECT(input, substr($[1]))
@@ -318,6 +335,227 @@ INSTANTIATE_TEST_SUITE_P(
           Data{
             new Tuple{4LL},
           }
+        ),
+        // AGG(PROJECT(CAST_DECIMAL($[1])), GROUP(0), COUNT())
+        std::make_tuple(
+          "723701F06700736101000110",
+          MakeDataForGroupDecimal(),
+          2,
+          Data{
+            new Tuple{DecimalP(std::string("1.5")), 3LL},
+            new Tuple{DecimalP(2L), 2LL},
+          }
         )
     )
 );
+
+static Batch *MakeBatch(const Data &data, const std::vector<Byte> &types) {
+  auto *batch = new Batch(data.size());
+  for (size_t j = 0; j < types.size(); ++j) {
+    auto column = Column::Make(types[j], data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      column.SetOperand(i, (*data[i])[j]);
+    }
+    batch->AddColumn(column);
+  }
+  ReleaseData(data);
+  return batch;
+}
+
+static std::vector<Tuple> SelectedRows(const Batch *batch, const std::shared_ptr<uint64_t[]> &selection) {
+  std::vector<Tuple> rows;
+  ForEachSelected(selection.get(), batch->Size(), [&](size_t i) {
+    std::unique_ptr<Tuple> tuple(batch->GetTuple(i));
+    rows.push_back(*tuple);
+  });
+  return rows;
+}
+
+TEST(BatchOpTest, Filter) {
+  // FILTER(input, $[2] > 50)
+  std::unique_ptr<const RelRunner> rel(MakeRunner("7134021442480000930400"));
+  std::shared_ptr<uint64_t[]> selection;
+  const auto *batch = rel->PutBatch(MakeBatch(MakeData(), {TYPE_INT32, TYPE_STRING, TYPE_FLOAT}), selection);
+  ASSERT_NE(selection, nullptr);
+  ASSERT_EQ(selection[0], 0xE0);
+  auto rows = SelectedRows(batch, selection);
+  ASSERT_EQ(rows.size(), 3);
+  EXPECT_EQ(rows[0], (Tuple{6, "Alice", 60.0f}));
+  EXPECT_EQ(rows[2], (Tuple{8, "Alice", 80.0f}));
+  delete batch;
+}
+
+TEST(BatchOpTest, FilterNotBool) {
+  // FILTER(input, $[0])
+  std::unique_ptr<const RelRunner> rel(MakeRunner("71310000"));
+  std::shared_ptr<uint64_t[]> selection;
+  // The batch is released by the op even if it throws.
+  EXPECT_THROW(rel->PutBatch(MakeBatch(MakeData(), {TYPE_INT32, TYPE_STRING, TYPE_FLOAT}), selection),
+               std::bad_variant_access);
+}
+
+TEST(BatchOpTest, FilterProject) {
+  // PROJECT(FILTER(input, $[2] > 50), $[0], $[1], $[2] / 10)
+  std::unique_ptr<const RelRunner> rel(MakeRunner("7134021442480000930400723100370134021441200000860400"));
+  std::shared_ptr<uint64_t[]> selection;
+  const auto *batch = rel->PutBatch(MakeBatch(MakeData(), {TYPE_INT32, TYPE_STRING, TYPE_FLOAT}), selection);
+  auto rows = SelectedRows(batch, selection);
+  ASSERT_EQ(rows.size(), 3);
+  EXPECT_EQ(rows[0], (Tuple{6, "Alice", 6.0f}));
+  EXPECT_EQ(rows[1], (Tuple{7, "Betty", 7.0f}));
+  EXPECT_EQ(rows[2], (Tuple{8, "Alice", 8.0f}));
+  delete batch;
+}
+
+TEST(BatchOpTest, FilterAgg) {
+  // AGG(FILTER(input, $[0] > 2), COUNT(), COUNT($[2]), SUM($[2]))
+  std::unique_ptr<const RelRunner> rel(MakeRunner("713100110293010074031014022402"));
+  // Put in two batches, the aggregations are accumulated.
+  for (int k = 0; k < 2; ++k) {
+    std::shared_ptr<uint64_t[]> selection;
+    const auto *batch = rel->PutBatch(MakeBatch(MakeData(), {TYPE_INT32, TYPE_STRING, TYPE_FLOAT}), selection);
+    ASSERT_EQ(batch, nullptr);
+  }
+  std::unique_ptr<const Tuple> out(rel->Get());
+  ASSERT_NE(out, nullptr);
+  EXPECT_EQ(*out, (Tuple{14LL, 12LL, 660.0f}));
+  ASSERT_EQ(rel->Get(), nullptr);
+}
+
+TEST(BatchOpTest, FilterGroupedAgg) {
+  // AGG(FILTER(input, $[0] > 2), GROUP(1), COUNT(), SUM($[2]))
+  std::unique_ptr<const RelRunner> rel(MakeRunner("71310011029301007361010102102402"));
+  std::shared_ptr<uint64_t[]> selection;
+  rel->PutBatch(MakeBatch(MakeData(), {TYPE_INT32, TYPE_STRING, TYPE_FLOAT}), selection);
+  Data expected{
+      new Tuple{"Alice", 2LL, 140.0f},
+      new Tuple{"Betty", 1LL, 70.0f},
+      new Tuple{"Cindy", 2LL, 30.0f},
+      new Tuple{"Doris", 1LL, 40.0f},
+      new Tuple{"Emily", 1LL, 50.0f},
+  };
+  for (size_t i = 0; i < expected.size(); ++i) {
+    std::unique_ptr<const Tuple> out(rel->Get());
+    ASSERT_NE(out, nullptr);
+    EXPECT_TRUE(std::any_of(expected.cbegin(), expected.cend(), [&out](const Tuple *t) { return *t == *out; }));
+  }
+  ASSERT_EQ(rel->Get(), nullptr);
+  ReleaseData(expected);
+}
+
+TEST(AggStateTest, UpdateInPlace) {
+  using dingodb::types::DecimalP;
+  op::SumAgg<DecimalP> sum(0);
+  op::MaxAgg<String> max(1);
+  op::CountAgg<String> count(1);
+  alignas(16) char sum_state[sizeof(op::CalcState<DecimalP>)];
+  alignas(16) char max_state[sizeof(op::CalcState<String>)];
+  int64_t count_state;
+  sum.Init(sum_state);
+  max.Init(max_state);
+  count.Init(&count_state);
+  ASSERT_EQ(sum.Finalize(sum_state), nullptr);
+  ASSERT_EQ(count.Finalize(&count_state), nullptr);
+  Data data{
+      new Tuple{DecimalP(std::string("1.25")), "Betty"},
+      new Tuple{nullptr, nullptr},
+      new Tuple{DecimalP(std::string("2.5")), "Alice"},
+      new Tuple{DecimalP(std::string("-0.75")), "Cindy"},
+  };
+  for (const auto *tuple : data) {
+    sum.Update(sum_state, tuple);
+    max.Update(max_state, tuple);
+    count.Update(&count_state, tuple);
+  }
+  ReleaseData(data);
+  ASSERT_EQ(sum.Finalize(sum_state), DecimalP(3L));
+  ASSERT_TRUE(reinterpret_cast<op::CalcState<DecimalP> *>(sum_state)->value.IsFixed());
+  ASSERT_EQ(max.Finalize(max_state), Operand("Cindy"));
+  ASSERT_EQ(count.Finalize(&count_state), Operand(3LL));
+  sum.Destroy(sum_state);
+  max.Destroy(max_state);
+  count.Destroy(&count_state);
+}
+
+TEST(GroupedAggOpTest, EqualDecimalKeys) {
+  using dingodb::types::DecimalP;
+  auto make_data = []() {
+    return Data{
+        new Tuple{DecimalP(std::string("1.50"))},
+        new Tuple{DecimalP(std::string("1.5"))},
+        new Tuple{DecimalP(dingodb::types::Decimal("1.500"))},
+        new Tuple{DecimalP(2L)},
+        new Tuple{nullptr},
+    };
+  };
+  auto make_op = []() {
+    return std::make_unique<op::GroupedAggOp>(new int[]{0}, 1, new std::vector<const op::Agg *>{new op::CountAllAgg()});
+  };
+  auto check = [](const op::GroupedAggOp &op) {
+    std::vector<Tuple> out;
+    while (const auto *tuple = op.Get()) {
+      out.push_back(*tuple);
+      delete tuple;
+    }
+    ASSERT_EQ(out.size(), 3);
+    for (const auto &tuple : out) {
+      if (tuple[0] == nullptr) {
+        EXPECT_EQ(tuple[1], Operand(1LL));
+      } else if (tuple[0] == Operand(DecimalP(2L))) {
+        EXPECT_EQ(tuple[1], Operand(1LL));
+      } else {
+        EXPECT_EQ(tuple[0], Operand(DecimalP(std::string("1.5"))));
+        EXPECT_EQ(tuple[1], Operand(3LL));
+      }
+    }
+  };
+  auto op = make_op();
+  for (auto *tuple : make_data()) {
+    op->Put(tuple);
+  }
+  check(*op);
+  auto batch_op = make_op();
+  std::shared_ptr<uint64_t[]> selection;
+  batch_op->PutBatch(MakeBatch(make_data(), {TYPE_DECIMAL}), selection);
+  check(*batch_op);
+}
+
+TEST(RelOpTest, StringViewsCopied) {
+  const std::string prefix = "A string too long to be inline, ";
+  std::vector<std::string> bufs{prefix + "1", prefix + "3", prefix + "2", prefix + "3"};
+  // The buffer of the rows is reused.
+  std::string buf;
+  auto put = [&bufs, &buf](const std::function<void(Tuple *)> &fun) {
+    for (const auto &str : bufs) {
+      buf = str;
+      fun(new Tuple{String::View(buf)});
+      buf.assign(buf.size(), 'x');
+    }
+  };
+  // AGG(input, MAX($[0]))
+  std::unique_ptr<const RelRunner> max(MakeRunner("74013700"));
+  put([&max](Tuple *tuple) { max->Put(tuple); });
+  std::unique_ptr<const Tuple> out(max->Get());
+  EXPECT_EQ(*out, (Tuple{prefix + "3"}));
+  // AGG(input, GROUP(0), COUNT())
+  op::GroupedAggOp group(new int[]{0}, 1, new std::vector<const op::Agg *>{new op::CountAllAgg()});
+  put([&group](Tuple *tuple) { group.Put(tuple); });
+  std::vector<Tuple> groups;
+  while (const auto *tuple = group.Get()) {
+    groups.push_back(*tuple);
+    delete tuple;
+  }
+  ASSERT_EQ(groups.size(), 3);
+  for (const auto &tuple : groups) {
+    auto count = (tuple[0] == Operand(prefix + "3") ? 2LL : 1LL);
+    EXPECT_NE(std::find(bufs.begin(), bufs.end(), std::string(tuple[0].GetStringView())), bufs.end());
+    EXPECT_EQ(tuple[1], Operand(count));
+  }
+  // PROJECT(input, $[0])
+  std::unique_ptr<const RelRunner> project(MakeRunner("72310000"));
+  std::vector<std::unique_ptr<const Tuple>> projected;
+  put([&](Tuple *tuple) { projected.emplace_back(project->Put(tuple)); });
+  for (size_t i = 0; i < bufs.size(); ++i) {
+    EXPECT_EQ(*projected[i], (Tuple{bufs[i]}));
+  }
+}
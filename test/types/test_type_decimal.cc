@@ -433,3 +433,131 @@ TEST(TestTypeDecimal, DecimalTest) {
 }
 
 
+
+TEST(TestTypeDecimal, FixedPoint) {
+  ASSERT_TRUE(DecimalP(std::string("123.450")).IsFixed());
+  ASSERT_TRUE(DecimalP(12L).IsFixed());
+  ASSERT_FALSE(DecimalP(std::string("1.5e3")).IsFixed());
+  ASSERT_FALSE(DecimalP(12.5).IsFixed());
+  ASSERT_EQ(DecimalP(std::string("123.450")).ToString(), "123.45");
+  ASSERT_EQ(DecimalP(std::string("-0.0012300")).ToString(), "-0.00123");
+  ASSERT_EQ(DecimalP(std::string("100.00")).ToString(), "100");
+  ASSERT_EQ(DecimalP(std::string("-0.000")).ToString(), "0");
+  ASSERT_EQ(DecimalP(std::string("12abc")).ToString(), "12");
+  ASSERT_EQ(DecimalP(std::string("abc")).ToString(), "0");
+  ASSERT_EQ(DecimalP(std::string("1.5e3")).ToString(), "1500");
+  // Too many digits to be fixed-point.
+  std::string digits = "1234567890123456789012345678901234567890.5";
+  DecimalP wide(digits);
+  ASSERT_FALSE(wide.IsFixed());
+  ASSERT_EQ(wide.ToString(), Decimal(digits).toString());
+  // The same value in both representations.
+  DecimalP a(std::string("12.34"));
+  DecimalP b(Decimal("12.34"));
+  ASSERT_TRUE(a.IsFixed());
+  ASSERT_FALSE(b.IsFixed());
+  ASSERT_EQ(a, b);
+  ASSERT_EQ(std::hash<DecimalP>()(a), std::hash<DecimalP>()(b));
+  ASSERT_EQ(a.GetPtr()->toString(10, 4), "12.3400");
+  ASSERT_EQ(a->toString(10, 1), "12.3");
+  ASSERT_EQ(a.toDouble(), 12.34);
+  ASSERT_EQ(a.toInt(), 12);
+  DecimalP big_fixed(std::string("-99999999999999999999.999999999999999999"));
+  ASSERT_TRUE(big_fixed.IsFixed());
+  ASSERT_EQ(DecimalP(std::string("-2.5")).toLong(), -3);
+  ASSERT_EQ(DecimalP(std::string("10000000000")).toLong(), INT64_C(10000000000));
+  ASSERT_EQ(DecimalP(std::string("-10000000000.4")).toLong(), INT64_C(-10000000000));
+  ASSERT_EQ(DecimalP(Decimal("10000000000")).toLong(), INT64_C(10000000000));
+  // Made from the unscaled value, not by formatting.
+  ASSERT_EQ(DecimalP(std::string("-0.0012300")).GetPtr()->toString(), "-0.00123");
+  ASSERT_EQ(big_fixed.GetPtr()->toString(), "-99999999999999999999.999999999999999999");
+  ASSERT_EQ(*big_fixed.GetPtr(), Decimal("-99999999999999999999.999999999999999999"));
+}
+
+TEST(TestTypeDecimal, FixedPointCalc) {
+  DecimalP a(std::string("12.34"));
+  DecimalP b(std::string("-0.006"));
+  ASSERT_TRUE((a + b).IsFixed());
+  ASSERT_EQ((a + b).ToString(), "12.334");
+  ASSERT_EQ((a - b).ToString(), "12.346");
+  ASSERT_EQ((a * b).ToString(), "-0.07404");
+  ASSERT_EQ((-a).ToString(), "-12.34");
+  ASSERT_EQ(b.Abs().ToString(), "0.006");
+  ASSERT_TRUE(b < a);
+  ASSERT_TRUE(a >= DecimalP(std::string("12.340")));
+  ASSERT_TRUE(a != b);
+  // Exact quotients are fixed-point.
+  auto q = a / DecimalP(std::string("0.8"));
+  ASSERT_TRUE(q.IsFixed());
+  ASSERT_EQ(q.ToString(), "15.425");
+  ASSERT_EQ((DecimalP(1L) / DecimalP(std::string("0.004"))).ToString(), "250");
+  ASSERT_EQ((DecimalP(-3L) / DecimalP(std::string("0.064"))).ToString(), "-46.875");
+  // Others fall back to GMP.
+  auto r = DecimalP(1L) / DecimalP(3L);
+  ASSERT_FALSE(r.IsFixed());
+  ASSERT_EQ(r, DecimalP(Decimal("1")) / DecimalP(Decimal("3")));
+  ASSERT_TRUE(r < DecimalP(std::string("0.34")));
+  // Overflow falls back to GMP.
+  DecimalP big(std::string("99999999999999999999999999999999999999"));
+  ASSERT_TRUE(big.IsFixed());
+  auto sum = big + big;
+  ASSERT_FALSE(sum.IsFixed());
+  ASSERT_EQ(sum.ToString(), "199999999999999999999999999999999999998");
+  std::string s0 = "0.00000000000000000001";
+  std::string s1 = "0.0000000000000000001";
+  auto prod = DecimalP(s0) * DecimalP(s1);
+  ASSERT_FALSE(prod.IsFixed());
+  ASSERT_EQ(prod, DecimalP(Decimal(s0)) * DecimalP(Decimal(s1)));
+}
+
+TEST(TestTypeDecimal, Compare) {
+  Decimal a("12.34");
+  Decimal b("12.340000000000000000000000001");
+  ASSERT_TRUE(a < b);
+  ASSERT_TRUE(b > a);
+  ASSERT_TRUE(a != b);
+  ASSERT_TRUE(a <= Decimal("12.34"));
+  ASSERT_TRUE(a >= Decimal("12.340"));
+  ASSERT_TRUE(Decimal("-1") < Decimal("0"));
+  ASSERT_TRUE(Decimal("0") < Decimal("0.0000000001"));
+  ASSERT_TRUE(Decimal("-2.5") < Decimal("-2.4"));
+  ASSERT_TRUE(Decimal("1000") > Decimal("999.999"));
+  // Different precisions.
+  Decimal c(mpf_class("0.5", 64));
+  Decimal d(mpf_class("0.5", 512));
+  ASSERT_EQ(c.compare(d), 0);
+  ASSERT_TRUE(c == d);
+  ASSERT_TRUE(Decimal(mpf_class("0.25", 256)) < c);
+  // Differ only in the bits rounded off by formatting, so equal as before.
+  Decimal third = Decimal("1") / Decimal("3");
+  ASSERT_EQ(third * Decimal("3"), Decimal("1"));
+  ASSERT_EQ(Decimal("0.1") + Decimal("0.2"), Decimal("0.3"));
+  // Fixed-point and GMP decimals.
+  ASSERT_TRUE(DecimalP(std::string("0.3")) < DecimalP(Decimal("0.30001")));
+  ASSERT_TRUE(DecimalP(Decimal("0.3")) == DecimalP(std::string("0.30")));
+}
+
+TEST(TestTypeDecimal, NormalizedKey) {
+  auto key = [](const DecimalP &v) {
+    std::string buf;
+    v.AppendKey(buf);
+    return buf;
+  };
+  DecimalP a(std::string("1.50"));
+  DecimalP b(std::string("1.5"));
+  DecimalP c(Decimal("1.500"));
+  ASSERT_EQ(a.Normalize().GetScale(), 1);
+  ASSERT_TRUE(c.Normalize().IsFixed());
+  ASSERT_EQ(key(a), key(b));
+  ASSERT_EQ(key(a), key(c));
+  ASSERT_EQ(key(a).size(), 17);
+  ASSERT_EQ(std::hash<DecimalP>()(a), std::hash<DecimalP>()(b));
+  ASSERT_EQ(std::hash<DecimalP>()(a), std::hash<DecimalP>()(c));
+  ASSERT_EQ(key(DecimalP(std::string("-0.00"))), key(DecimalP(0L)));
+  ASSERT_NE(key(a), key(DecimalP(std::string("-1.5"))));
+  ASSERT_NE(key(a), key(DecimalP(std::string("15"))));
+  auto third = DecimalP(1L) / DecimalP(3L);
+  ASSERT_FALSE(third.Normalize().IsFixed());
+  ASSERT_EQ(key(third)[0], '\xFF');
+  ASSERT_EQ(std::hash<DecimalP>()(third), std::hash<DecimalP>()(DecimalP(1L) / DecimalP(3L)));
+}